@@ -30,8 +30,18 @@ int main(int argc, char** argv) {
         std::string arg = argv[i];
 
         if (arg.find("--") == 0) {
-            std::cerr << "Unknown argument " << arg << std::endl;
-            return 2;
+            if (arg == "--replay" && i + 1 < argc) {
+                // debug an execution that was recorded with wasmint --record
+                try {
+                    debugger.vm().journal().replay(argv[++i]);
+                } catch (const std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "Unknown argument " << arg << std::endl;
+                return 2;
+            }
         } else {
             const std::string& modulePath = argv[i];
 
@@ -40,9 +40,9 @@ namespace wasmint {
             RandomModule* module = new RandomModule();
             module->context().name("random");
 
-            module->addFunction("rand32", Int32::instance(), {},
-                [=](std::vector<Variable> parameters) {
-                    return Variable::createInt32((int32_t) module->generator());
+            module->addTypedFunction<int32_t()>("rand32",
+                [=]() {
+                    return (int32_t) module->generator();
                 }
             );
             return module;
@@ -72,13 +72,13 @@ namespace wasmint {
 
             // alternating returns 1 or the sequence of increasing uneven numbers
             // only useful for testing the halting problem detector
-            module->addFunction("uneven", Int32::instance(), {},
-                [=](std::vector<Variable> parameters) {
+            module->addTypedFunction<int32_t()>("uneven",
+                [=]() {
                     module->counter_++;
                     if (module->counter_ % 2 == 0) {
-                        return Variable::createInt32(1);
+                        return (int32_t) 1;
                     } else {
-                        return Variable::createInt32(module->counter_);
+                        return (int32_t) module->counter_;
                     }
                 }
             );
@@ -60,14 +60,13 @@ wasm_module::Module* StdioModule::create() {
                                         return Void::instance();
                                     });
 
-        module->addFunction("sleep", Void::instance(), {Int32::instance()},
-                                    [](std::vector<Variable> parameters) {
+        module->addTypedFunction<void(int32_t)>("sleep",
+                                    [](int32_t time) {
 #ifdef _WIN32
-                                        Sleep(Int32::getValue(parameters.at(0)));
+                                        Sleep(time);
 #else
-                                        usleep(Int32::getValue(parameters.at(0)));
+                                        usleep(time);
 #endif
-                                        return Void::instance();
                                     });
         return module;
 }
@@ -28,6 +28,15 @@
 
 namespace wasmint {
 
+    /**
+     * The bytecode of a single compiled function.
+     *
+     * By default every opcode is stored as a full word and all immediates are word sized, so each
+     * instruction starts at a 4 byte aligned address. If WASMINT_COMPACT_BYTECODE is defined, opcodes
+     * take a single byte and the small immediates (offsets, local indexes, parameter counts) are
+     * stored as unsigned LEB128. Jump targets and function indexes stay fixed width in both
+     * encodings as the compiler patches them after the code has been emitted.
+     */
     class ByteCode {
 
         std::size_t usedCodeSize_ = 0;
@@ -42,6 +51,14 @@ namespace wasmint {
         }
         
     public:
+#ifdef WASMINT_COMPACT_BYTECODE
+        typedef uint8_t OpcodeWord;
+#else
+        typedef uint32_t OpcodeWord;
+#endif
+        // every instruction in the bytecode starts at a multiple of this value
+        static const std::size_t instructionAlignment = sizeof(OpcodeWord);
+
         ByteCode() {
         }
 
@@ -71,23 +88,57 @@ namespace wasmint {
 
         template<typename T>
         void getUnsafe(T* target, std::size_t position) const {
-            (*target) = *((T*) (data() + position));
+            // memcpy instead of a pointer cast as the compact encoding doesn't align its operands
+            std::memcpy(target, data() + position, sizeof(T));
+        }
+
+        /**
+         * Reads an immediate that was written with appendImmediate and moves
+         * the given position behind it.
+         */
+        uint32_t getImmediate(uint32_t& position) const {
+#ifdef WASMINT_COMPACT_BYTECODE
+            uint32_t result = 0;
+            uint32_t shift = 0;
+            uint8_t byte;
+            do {
+                byte = data()[position++];
+                result |= ((uint32_t) (byte & 0x7Fu)) << shift;
+                shift += 7;
+            } while (byte & 0x80u);
+            return result;
+#else
+            uint32_t result;
+            getUnsafe(&result, position);
+            position += sizeof(result);
+            return result;
+#endif
         }
 
         void appendOpcode(ByteOpcode opcode) {
-            append((uint32_t) opcode);
+            append((OpcodeWord) opcode);
+        }
+
+        void appendImmediate(uint32_t value) {
+#ifdef WASMINT_COMPACT_BYTECODE
+            do {
+                uint8_t byte = (uint8_t) (value & 0x7Fu);
+                value >>= 7;
+                if (value != 0)
+                    byte |= 0x80u;
+                append(byte);
+            } while (value != 0);
+#else
+            append(value);
+#endif
         }
 
         template<typename T>
         void append(T value) {
             usedCodeSize_ += sizeof value;
             if (usedCodeSize_ > byteCode_.size() * 4) {
-                if (usedCodeSize_ % 4 == 0) {
-                    byteCode_.resize(usedCodeSize_ / 4);
-                } else {
-                    // round up to the next word
-                    byteCode_.resize((usedCodeSize_ / 4 + 1) * 4);
-                }
+                // round up to the next word
+                byteCode_.resize((usedCodeSize_ + 3) / 4);
             }
             memcpy(data() + (usedCodeSize_ - sizeof(value)), &value, sizeof(value));
         }
@@ -206,7 +206,9 @@ namespace wasmint {
 
         CopyReg,
         Nop,
-        End
+        End,
+        // replaces the opcode at a breakpoint in the code of a single VM
+        Breakpoint
         };
         
         inline std::string name(ByteOpcodes::Values opcode) {
@@ -225,6 +227,7 @@ namespace wasmint {
                 "I32ShiftLeft",
                 "I32ShiftRightZeroes",
                 "I32ShiftRightSigned",
+                "I32EqualZero",
                 "I32Equal",
                 "I32NotEqual",
                 "I32LessThanSigned",
@@ -252,6 +255,7 @@ namespace wasmint {
                 "I64ShiftLeft",
                 "I64ShiftRightZeroes",
                 "I64ShiftRightSigned",
+                "I64EqualZero",
                 "I64Equal",
                 "I64NotEqual",
                 "I64LessThanSigned",
@@ -277,12 +281,14 @@ namespace wasmint {
                 "Branch",
                 "BranchIf",
                 "BranchIfNot",
-                "BranchCopyReg",
-                "BranchIfCopyReg",
-                "BranchIfNotCopyReg",
 
                 "GetLocal",
                 "SetLocal",
+                "TeeLocal",
+
+                "ClearStackPreserveTop",
+
+                "Drop",
 
                 "GrowMemory",
                 "PageSize",
@@ -386,7 +392,8 @@ namespace wasmint {
 
                 "CopyReg",
                 "Nop",
-                "End"
+                "End",
+                "Breakpoint"
             };
             if (opcode >= names.size()) {
                 return "Unknown opcode";
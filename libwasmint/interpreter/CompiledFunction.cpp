@@ -16,3 +16,28 @@
 
 
 #include "CompiledFunction.h"
+#ifdef WASMINT_NATIVE_JIT
+#include <interpreter/native/NativeCompiler.h>
+#endif
+
+namespace wasmint {
+
+#ifdef WASMINT_NATIVE_JIT
+    const NativeCode* CompiledFunction::nativeCode() {
+        if (!triedNativeCompilation_) {
+            triedNativeCompilation_ = true;
+            auto start = std::chrono::steady_clock::now();
+            try {
+                NativeCompiler compiler;
+                nativeCode_ = compiler.compile(hasBreakpoints() ? codeWithoutBreakpoints() : code());
+            } catch (const CantAllocateExecutableMemory& ex) {
+                // we just stay in the interpreter if the system doesn't give us executable memory
+                nativeCode_ = nullptr;
+            }
+            nativeCompileTime_ = std::chrono::steady_clock::now() - start;
+        }
+        return nativeCode_.get();
+    }
+#endif
+
+}
@@ -22,14 +22,62 @@
 #include <interpreter/debugging/Breakpoint.h>
 #include "ByteCode.h"
 #include "JITCompiler.h"
+#include <limits>
+#include <atomic>
+#include <chrono>
+#ifdef WASMINT_NATIVE_JIT
+#include <memory>
+#include <interpreter/native/NativeCode.h>
+#endif
 
 namespace wasmint {
     class VMState;
 
+    /**
+     * A saturating counter that threads replaying the history can increment concurrently.
+     * Concurrent increments can get lost, which doesn't matter for a hotness heuristic.
+     */
+    class HotnessCounter {
+        std::atomic<uint32_t> value_;
+
+    public:
+        HotnessCounter() : value_(0) {
+        }
+
+        HotnessCounter(const HotnessCounter& other) : value_(other.value()) {
+        }
+
+        HotnessCounter& operator=(const HotnessCounter& other) {
+            value_.store(other.value(), std::memory_order_relaxed);
+            return *this;
+        }
+
+        void increment() {
+            uint32_t value = value_.load(std::memory_order_relaxed);
+            if (value != std::numeric_limits<uint32_t>::max())
+                value_.store(value + 1, std::memory_order_relaxed);
+        }
+
+        uint32_t value() const {
+            return value_.load(std::memory_order_relaxed);
+        }
+    };
+
     class CompiledFunction {
         const wasm_module::Function* function_;
         JITCompiler debugCompiler_;
         std::unordered_map<uint32_t, Breakpoint> breakpointsByInstructionAddress_;
+        // the opcodes that were replaced by ByteOpcodes::Breakpoint
+        std::unordered_map<uint32_t, ByteCode::OpcodeWord> originalOpcodes_;
+
+        // hotness counters for the TieringPolicy
+        HotnessCounter callCount_;
+        HotnessCounter backEdgeCount_;
+#ifdef WASMINT_NATIVE_JIT
+        std::shared_ptr<NativeCode> nativeCode_;
+        bool triedNativeCompilation_ = false;
+        std::chrono::nanoseconds nativeCompileTime_{0};
+#endif
 
     public:
         CompiledFunction() {
@@ -54,9 +102,75 @@ namespace wasmint {
             return debugCompiler_;
         }
 
+        void countCall() {
+            callCount_.increment();
+        }
+
+        void countBackEdge() {
+            backEdgeCount_.increment();
+        }
+
+        uint32_t callCount() const {
+            return callCount_.value();
+        }
+
+        uint32_t backEdgeCount() const {
+            return backEdgeCount_.value();
+        }
+
+#ifdef WASMINT_NATIVE_JIT
+        /**
+         * Returns the machine code of this function and compiles it on the first call.
+         * Returns a nullptr if the function can't be executed natively.
+         */
+        const NativeCode* nativeCode();
+
+        /**
+         * True if this function was already promoted to native code.
+         */
+        bool promoted() const {
+            return triedNativeCompilation_;
+        }
+
+        std::chrono::nanoseconds nativeCompileTime() const {
+            return nativeCompileTime_;
+        }
+#endif
+
+        /**
+         * Stops the execution after the given instruction by replacing the next opcode with a
+         * breakpoint opcode. The code without breakpoints doesn't pay for the lookup.
+         */
         void addBreakpoint(const wasm_module::Instruction* instruction, BreakpointHandler* handler = nullptr) {
             uint32_t address = debugCompiler_.getInstructionEndAddress(instruction);
             breakpointsByInstructionAddress_[address] = Breakpoint(instruction, handler);
+            if (originalOpcodes_.find(address) == originalOpcodes_.end()) {
+                ByteCode& code = debugCompiler_.code();
+                originalOpcodes_[address] = code.get<ByteCode::OpcodeWord>(address);
+                code.write<ByteCode::OpcodeWord>(address, (ByteCode::OpcodeWord) ByteOpcodes::Breakpoint);
+            }
+        }
+
+        bool hasBreakpoints() const {
+            return !originalOpcodes_.empty();
+        }
+
+        /**
+         * The opcode that was replaced by the breakpoint at the given address.
+         */
+        ByteCode::OpcodeWord originalOpcode(uint32_t address) const {
+            return originalOpcodes_.at(address);
+        }
+
+        /**
+         * A copy of the code with the original opcodes at the breakpoints.
+         */
+        ByteCode codeWithoutBreakpoints() const {
+            ByteCode result = code();
+            for (const auto& pair : originalOpcodes_) {
+                result.write<ByteCode::OpcodeWord>(pair.first, pair.second);
+            }
+            return result;
         }
 
         bool triggerBreakpoints(VMState& runner, uint32_t instructionPointer) {
@@ -28,11 +28,17 @@ namespace wasmint {
 
 void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
-    uint32_t opcode;
-    popFromCode<uint32_t>(&opcode);
+    ByteCode::OpcodeWord opcode;
+    popFromCode<ByteCode::OpcodeWord>(&opcode);
 
     //dumpStatus((ByteOpcodes::Values) opcode, opcodeData);
 
+dispatch:
+#ifdef WASMINT_OPCODE_STATS
+    // replayed states were already counted, and the parallel halting search replays in several threads
+    if (!runner.machine().reconstructing())
+        runner.machine().opcodeStatistics().count(opcode, function_->function());
+#endif
     switch (opcode) {
         /******************************************************
          ***************** Int 32 Operations ******************
@@ -116,14 +122,14 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I32ShiftLeft: {
             auto right = pop<uint32_t>();
             auto left = pop<uint32_t>();
-            push(left << right);
+            push(left << (right % 32));
             break;
         }
 
         case ByteOpcodes::I32ShiftRightZeroes: {
             auto right = pop<uint32_t>();
             auto left = pop<uint32_t>();
-            push(left >> (right & 32));
+            push(left >> (right % 32));
             break;
         }
 
@@ -544,13 +550,20 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
              ******************************************************/
 
         case ByteOpcodes::Branch:
-            instructionPointer_ = popFromCode<uint32_t>();
+        {
+            uint32_t jumpOffset = popFromCode<uint32_t>();
+            if (jumpOffset < instructionPointer_)
+                function_->countBackEdge();
+            instructionPointer_ = jumpOffset;
             break;
+        }
 
         case ByteOpcodes::BranchIf:
         {
             uint32_t jumpOffset = popFromCode<uint32_t>();
             if (pop<uint32_t>()) {
+                if (jumpOffset < instructionPointer_)
+                    function_->countBackEdge();
                 instructionPointer_ = jumpOffset;
             }
             break;
@@ -559,6 +572,8 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         {
             uint32_t jumpOffset = popFromCode<uint32_t>();
             if (!pop<uint32_t>()) {
+                if (jumpOffset < instructionPointer_)
+                    function_->countBackEdge();
                 instructionPointer_ = jumpOffset;
             }
             break;
@@ -572,7 +587,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::TableSwitch:
         {
-            uint32_t tableSize = popFromCode<uint32_t>();
+            uint32_t tableSize = popImmediate();
             uint32_t tableIndex = pop<uint32_t>();
             if (tableIndex < tableSize) {
                 // multiply tableIndex with 4 as each address in the jump table is 4 bytes long
@@ -586,10 +601,26 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         }
 
         case ByteOpcodes::CallImport:
+        {
+            uint32_t functionId = popFromCode<uint32_t>();
+            uint32_t parameterSize = popImmediate();
+            const wasm_module::Function& target = runner.machine().getCompiledFunction(functionId).function();
+            // the type ids behind the call are only consumed by variadic functions
+            if (!target.variadic()) {
+                for (uint32_t i = 0; i < parameterSize; i++) {
+                    popImmediate();
+                }
+            }
+            if (!target.isNative())
+                runner.countDirectCall();
+            runner.enterFunction(functionId, parameterSize);
+            break;
+        }
         case ByteOpcodes::Call:
         {
             uint32_t functionId = popFromCode<uint32_t>();
-            uint32_t parameterSize = popFromCode<uint32_t>();
+            uint32_t parameterSize = popImmediate();
+            runner.countDirectCall();
             runner.enterFunction(functionId, parameterSize);
             break;
         }
@@ -601,13 +632,14 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
                 break;
             }
             uint16_t localFunctionId = (uint16_t) signedLocalFunctionId;
-            uint16_t neededIndex = popFromCode<uint16_t>();
+            uint32_t neededIndex = popImmediate();
             try {
                 const wasm_module::FunctionSignature& signature = function_->function().module().context().indirectCallTable().getFunctionSignature(localFunctionId);
                 std::size_t index = signature.index();
                 if (index == neededIndex) {
                     uint32_t functionId = (uint32_t) runner.machine().getIndex(signature.moduleName(), signature.name());
-                    uint16_t parameterSize = popFromCode<uint16_t>();
+                    uint32_t parameterSize = popImmediate();
+                    runner.countIndirectCall();
                     runner.enterFunction(functionId, parameterSize);
                 } else {
                     runner.trap("indirect call signature mismatch");
@@ -618,16 +650,13 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
             break;
         }
         case ByteOpcodes::SetLocal:
-            setVariable(popFromCode<uint16_t>(), pop<uint64_t>());
-            popFromCode<uint16_t>(); // pop alignment data
+            setVariable(popImmediate(), pop<uint64_t>());
             break;
         case ByteOpcodes::TeeLocal:
-            setVariable(popFromCode<uint16_t>(), peek<uint64_t>());
-            popFromCode<uint16_t>(); // pop alignment data
+            setVariable(popImmediate(), peek<uint64_t>());
             break;
         case ByteOpcodes::GetLocal:
-            push(getVariable(popFromCode<uint16_t>()));
-            popFromCode<uint16_t>(); // pop alignment data
+            push(getVariable(popImmediate()));
             break;
 
         case ByteOpcodes::ClearStackPreserveTop: {
@@ -665,6 +694,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
             size_t oldSize = heap.pageCount();
             // TODO risky conversion
             if (heap.growPages((uint32_t) value)) {
+                runner.countHeapGrowth();
                 push(oldSize);
             } else {
                 push((uint32_t) -1);
@@ -687,7 +717,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I32Load8Signed:
         {
             int8_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -696,7 +726,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I32Load8Unsigned:
         {
             uint8_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -705,7 +735,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I32Load16Signed:
         {
             int16_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -714,7 +744,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I32Load16Unsigned:
         {
             uint16_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -722,7 +752,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I32Load:
         {
             uint32_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -731,7 +761,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         case ByteOpcodes::I64Load8Signed:
         {
             int8_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -739,7 +769,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::I64Load8Unsigned: {
             uint8_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -747,7 +777,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::I64Load16Signed: {
             int16_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -755,7 +785,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::I64Load16Unsigned: {
             uint16_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -763,7 +793,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::I64Load32Signed: {
             int32_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -771,7 +801,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::I64Load32Unsigned: {
             uint32_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -779,7 +809,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::I64Load: {
             uint64_t value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -787,7 +817,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::F32Load: {
             float value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
@@ -795,66 +825,66 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
 
         case ByteOpcodes::F64Load: {
             double value;
-            if (!heap.getStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(), &value))
+            if (!heap.getStaticOffset(pop<uint32_t>(), popImmediate(), &value))
                 return runner.trap("out of bounds memory access");
             push(value);
             break;
         }
         case ByteOpcodes::I32Store8: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint8_t>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
 
         case ByteOpcodes::I32Store16: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint16_t>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
 
         case ByteOpcodes::I64Store8: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint8_t>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
 
         case ByteOpcodes::I64Store16: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint16_t>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
 
         case ByteOpcodes::I64Store32: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint32_t>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
 
         case ByteOpcodes::F32Store: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<float>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
         case ByteOpcodes::F64Store: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<double>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
         case ByteOpcodes::I32Store: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint32_t>()))
                 return runner.trap("out of bounds memory access");
             break;
         }
         case ByteOpcodes::I64Store: {
-            if (!heap.setStaticOffset(pop<uint32_t>(), popFromCode<uint32_t>(),
+            if (!heap.setStaticOffset(pop<uint32_t>(), popImmediate(),
                                       pop<uint64_t>()))
                 return runner.trap("out of bounds memory access");
             break;
@@ -871,12 +901,7 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
             auto condition = pop<uint32_t>();
             auto falseResult = pop<uint64_t>();
             auto trueResult = pop<uint64_t>();
-            if (condition) {
-                pop<uint64_t>();
-                push(pop<uint64_t>());
-            } else {
-                push(pop<uint64_t>());
-            }
+            push(condition ? trueResult : falseResult);
             break;
         }
             /******************************************************
@@ -1549,6 +1574,22 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
             else
                 runner.finishFrame(pop<uint64_t>());
             break;
+
+        case ByteOpcodes::Breakpoint: {
+            uint32_t address = instructionPointer_ - (uint32_t) sizeof(opcode);
+            if (runner.stopAtBreakpoints() && !runner.passBreakpoint()) {
+                // the replaced instruction is executed when the thread continues
+                instructionPointer_ = address;
+                runner.breakpointHit(true);
+                // searching for the previous breakpoint replays the history
+                if (!runner.machine().reconstructing())
+                    function_->triggerBreakpoints(runner.machine().state(), address);
+                return;
+            }
+            runner.passBreakpoint(false);
+            opcode = function_->originalOpcode(address);
+            goto dispatch;
+        }
         default:
             return runner.trap("Unknown instruction with opcode " + std::to_string(opcode));
     }
@@ -1576,9 +1617,4 @@ void FunctionFrame::stepInternal(VMThread &runner, Heap &heap) {
         } /**/
 
     }
-
-    bool FunctionFrame::stepDebug(VMThread &runner, Heap &heap) {
-        stepInternal(runner, heap);
-        return function_->triggerBreakpoints(runner.machine().state(), instructionPointer_);
-    }
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include "ByteCode.h"
 #include "CompiledFunction.h"
 #include "ValueStack.h"
+#include "StateHash.h"
 
 namespace wasmint {
     class VMThread;
@@ -77,6 +78,10 @@ namespace wasmint {
             instructionPointer_ += sizeof(T);
         }
 
+        uint32_t popImmediate() {
+            return code_->getImmediate(instructionPointer_);
+        }
+
         template<typename T>
         T peekFromCode(uint32_t offset = 0) {
             T result = code_->get<T>(offset + instructionPointer_);
@@ -94,7 +99,6 @@ namespace wasmint {
         }
 
         void step(VMThread &runner, Heap &heap);
-        bool stepDebug(VMThread &runner, Heap &heap);
 
         bool operator==(const FunctionFrame& other) const {
             if (code_ != other.code_)
@@ -120,10 +124,47 @@ namespace wasmint {
             return !(*this == other);
         }
 
+        /**
+         * Hash of everything operator== compares.
+         */
+        uint64_t hash() const {
+            uint64_t result = StateHash::combine((uint64_t) (uintptr_t) function_, instructionPointer_);
+            result = StateHash::combine(result, functionTargetRegister_);
+            result = StateHash::combine(result, variables_.data(), variables_.size());
+            return StateHash::combine(result, stack_.values(), stack_.size());
+        }
+
+        /**
+         * Approximate number of bytes this frame occupies including its variables and stack.
+         */
+        std::size_t memoryUsage() const {
+            return sizeof(FunctionFrame) + (variables_.size() + stack_.size()) * sizeof(uint64_t);
+        }
+
         const CompiledFunction& function() const {
             return *function_;
         }
 
+        CompiledFunction& function() {
+            return *function_;
+        }
+
+        uint32_t instructionPointer() const {
+            return instructionPointer_;
+        }
+
+        void instructionPointer(uint32_t address) {
+            instructionPointer_ = address;
+        }
+
+        ValueStack& stack() {
+            return stack_;
+        }
+
+        uint64_t* variables() {
+            return variables_.data();
+        }
+
         template<typename T>
         void push(T value) {
             stack_.push<T>(value);
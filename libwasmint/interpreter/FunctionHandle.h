@@ -0,0 +1,57 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_FUNCTIONHANDLE_H
+#define WASMINT_FUNCTIONHANDLE_H
+
+#include <cstddef>
+#include <Function.h>
+
+namespace wasmint {
+
+    /**
+     * A function that was already resolved in a specific WasmintVM. Can be passed to
+     * WasmintVM::call() as often as needed without looking up the function again.
+     */
+    class FunctionHandle {
+
+        std::size_t index_ = 0;
+        const wasm_module::Function* function_ = nullptr;
+
+    public:
+        FunctionHandle() {
+        }
+
+        FunctionHandle(std::size_t index, const wasm_module::Function& function)
+                : index_(index), function_(&function) {
+        }
+
+        bool valid() const {
+            return function_ != nullptr;
+        }
+
+        std::size_t index() const {
+            return index_;
+        }
+
+        const wasm_module::Function& function() const {
+            return *function_;
+        }
+    };
+}
+
+#endif //WASMINT_FUNCTIONHANDLE_H
@@ -16,3 +16,191 @@
 
 
 #include "History.h"
+#include <iterator>
+
+namespace wasmint {
+
+    void History::addCheckpoint(VMState& machine) {
+        enabled_ = true;
+        std::size_t chunkSize = heapPatchChunkSize_;
+        if (dirtyPageTracking_) {
+            flushDirtyPages();
+            chunkSize = systemPageSize();
+        }
+        auto iter = patches_.find(machine.instructionCounter());
+        if (iter != patches_.end()) {
+            // nothing was recorded in the old patch for this counter yet
+            delete iter->second;
+            iter->second = new MachinePatch(machine, chunkSize);
+        } else {
+            if (!patches_.empty()) {
+                finishedPatchesMemoryUsage_ += patches_.begin()->second->memoryUsage();
+            }
+            patches_[machine.instructionCounter()] = new MachinePatch(machine, chunkSize);
+        }
+        nextCheckpoint_ = machine.instructionCounter().toUint64() + currentCheckpointInterval_;
+
+        if (dirtyPageTracking_) {
+            // the pages saved in the new patch start clean again
+            pageTracker_.arm(machine.heap());
+        }
+
+        if (currentCheckpointInterval_ != 0 && finishedPatchesMemoryUsage_ > memoryLimit_) {
+            thinCheckpoints();
+        }
+    }
+
+    void History::thinCheckpoints() {
+        // The oldest patch is the last one in the map. Starting there, each second patch is merged
+        // into its predecessor. The newest patch is still recording and stays untouched.
+        auto newestIter = patches_.begin();
+        auto iter = patches_.end();
+        while (iter != newestIter) {
+            --iter;
+            auto newerIter = iter;
+            if (newerIter == newestIter)
+                break;
+            --newerIter;
+            if (newerIter == newestIter)
+                break;
+
+            iter->second->merge(*newerIter->second);
+            delete newerIter->second;
+            patches_.erase(newerIter);
+        }
+
+        finishedPatchesMemoryUsage_ = 0;
+        for (auto patchIter = std::next(patches_.begin()); patchIter != patches_.end(); ++patchIter) {
+            finishedPatchesMemoryUsage_ += patchIter->second->memoryUsage();
+        }
+        currentCheckpointInterval_ *= 2;
+    }
+
+    void History::setToState(const InstructionCounter& targetCounter, VMState& state) {
+        if (!enabled_)
+            throw HistoryNotEnabled("History recording was not enabled. Can't use setToState()");
+        if (targetCounter == state.instructionCounter()) {
+            // nothing to do here
+            return;
+        }
+        if (targetCounter > latestStateCounter_) {
+            throw TargetStateInTheFuture("Target state is behind the last recorded state");
+        }
+
+        if (!pageTracker_.armed()) {
+            restoreState(targetCounter, state);
+            return;
+        }
+
+        // applying the patches and replaying must not be recorded as modifications
+        flushDirtyPages();
+        pageTracker_.disarm();
+        try {
+            restoreState(targetCounter, state);
+        } catch (...) {
+            pageTracker_.arm(state.heap());
+            throw;
+        }
+        pageTracker_.arm(state.heap());
+    }
+
+    bool History::reverseContinue(VMState& state) {
+        if (!enabled_)
+            throw HistoryNotEnabled("History recording was not enabled. Can't use reverseContinue()");
+
+        const InstructionCounter currentCounter = state.instructionCounter();
+        const bool stoppedAtCurrentCounter = state.stoppedAtBreakpoint();
+
+        // replaying the intervals must not be recorded as modifications
+        const bool tracking = pageTracker_.armed();
+        flushDirtyPages();
+        pageTracker_.disarm();
+
+        bool found = false;
+        bool stoppedAtBreakpoint = false;
+        InstructionCounter stopCounter;
+        try {
+            InstructionCounter end = currentCounter;
+            while (!found && InstructionCounter(0) < end) {
+                InstructionCounter last = end;
+                --last;
+                auto patchIter = patches_.lower_bound(last);
+                if (patchIter == patches_.end())
+                    break;
+                const InstructionCounter start = patchIter->first.counter;
+
+                restoreState(start, state);
+                reconstructing_ = true;
+                // the last stop in the interval is the one we are looking for
+                while (state.instructionCounter() < end && state.stepUntil(end, true)) {
+                    if (state.instructionCounter() < end) {
+                        found = true;
+                        stopCounter = state.instructionCounter();
+                        stoppedAtBreakpoint = state.stoppedAtBreakpoint();
+                    }
+                }
+                reconstructing_ = false;
+                end = start;
+            }
+            restoreState(found ? stopCounter : currentCounter, state);
+        } catch (...) {
+            reconstructing_ = false;
+            if (tracking)
+                pageTracker_.arm(state.heap());
+            throw;
+        }
+        if (tracking)
+            pageTracker_.arm(state.heap());
+
+        // continuing from here passes the breakpoint instead of stopping at it again
+        if (found ? stoppedAtBreakpoint : stoppedAtCurrentCounter)
+            state.markStoppedAtBreakpoint();
+        return found;
+    }
+
+    void History::rollback(const InstructionCounter& targetCounter, VMState& state) const {
+        auto targetIter = patches_.lower_bound(targetCounter);
+        if (targetIter == patches_.end()) {
+            throw TargetStateNotInHistory("Can't rollback back to state with counter " + targetCounter.toString());
+        } else {
+            auto startIter = patches_.upper_bound(state.instructionCounter());
+            if (startIter == patches_.end()) {
+                throw TargetStateNotInHistory("Can't rollback back to state with counter " + targetCounter.toString());
+            } else {
+                for (;startIter != targetIter; ++startIter) {
+                    startIter->second->apply(state);
+                }
+                targetIter->second->apply(state);
+            }
+        }
+    }
+
+    void History::restoreState(const InstructionCounter& targetCounter, VMState& state) {
+        if (targetCounter < state.instructionCounter()) {
+            rollback(targetCounter, state);
+        }
+
+        if (!(state.instructionCounter() < targetCounter))
+            return;
+
+        // the replayed stores were already recorded, so the history doesn't need to see them
+        const bool observing = state.heap().removeObserver(*this);
+        reconstructing_ = true;
+        bool reachedTarget;
+        try {
+            reachedTarget = state.replayUntil(targetCounter);
+        } catch (...) {
+            reconstructing_ = false;
+            if (observing)
+                state.heap().attachObserver(*this);
+            throw;
+        }
+        reconstructing_ = false;
+        if (observing)
+            state.heap().attachObserver(*this);
+
+        if (!reachedTarget && state.instructionCounter() != targetCounter) {
+            throw TargetStateNotInHistory("Target state can't be reached (thread has finished)");
+        }
+    }
+}
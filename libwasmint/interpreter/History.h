@@ -50,11 +50,39 @@ namespace wasmint {
 
         InstructionCounter latestStateCounter_;
 
+        // automatic checkpoints, an interval of 0 disables them
+        uint64_t checkpointInterval_ = 100000;
+        std::size_t memoryLimit_ = 256 * 1024 * 1024;
+        // grows each time the checkpoints are thinned out
+        uint64_t currentCheckpointInterval_ = checkpointInterval_;
+        InstructionCounter nextCheckpoint_;
+        // memory used by all patches except the newest one which is still growing
+        std::size_t finishedPatchesMemoryUsage_ = 0;
+
+        std::size_t heapPatchChunkSize_ = HeapPatch::defaultChunkSize;
+
+        // finds the modified heap pages via memory protection instead of observing every store
+        bool dirtyPageTracking_ = false;
+        DirtyPageTracker pageTracker_;
+
+        void thinCheckpoints();
+
+        void restoreState(const InstructionCounter& targetCounter, VMState& state);
+
+        /**
+         * Moves the pages the tracker saved since the last checkpoint into the newest patch.
+         */
+        void flushDirtyPages() {
+            if (pageTracker_.armed() && !patches_.empty())
+                pageTracker_.flush(patches_.begin()->second->heapPatch());
+        }
+
     public:
         History() {
         }
 
         void clear() {
+            pageTracker_.disarm();
             for (auto& pair : patches_) {
                 delete pair.second;
             }
@@ -63,6 +91,101 @@ namespace wasmint {
             reconstructing_ = false;
             enabled_ = false;
             latestStateCounter_ = 0;
+            currentCheckpointInterval_ = checkpointInterval_;
+            nextCheckpoint_ = 0;
+            finishedPatchesMemoryUsage_ = 0;
+        }
+
+        /**
+         * Configures the checkpoints that are added while the VM runs. A checkpoint is added every
+         * interval instructions, so rolling back only has to replay at most interval instructions.
+         * If the checkpoints use more than memoryLimit bytes, every second checkpoint is merged into
+         * its predecessor and the interval is doubled. The first checkpoint is always kept, so every
+         * recorded state stays reachable. An interval of 0 disables automatic checkpoints.
+         */
+        void automaticCheckpoints(uint64_t interval, std::size_t memoryLimit) {
+            checkpointInterval_ = interval;
+            currentCheckpointInterval_ = interval;
+            memoryLimit_ = memoryLimit;
+            if (!patches_.empty())
+                nextCheckpoint_ = patches_.begin()->first.counter.toUint64() + interval;
+        }
+
+        /**
+         * The granularity in bytes in which the heap is saved. Smaller chunks save memory if
+         * stores are sparse, bigger chunks make programs with dense stores faster. Only affects
+         * checkpoints that are added afterwards, so this should be set before recording starts.
+         */
+        void heapPatchChunkSize(std::size_t chunkSize) {
+            if (chunkSize == 0)
+                throw InvalidChunkSize("The chunk size of a heap patch can't be 0");
+            heapPatchChunkSize_ = chunkSize;
+        }
+
+        std::size_t heapPatchChunkSize() const {
+            if (dirtyPageTracking_)
+                return pageTracker_.pageSize();
+            return heapPatchChunkSize_;
+        }
+
+        /**
+         * Instead of backing up the heap from a callback on every store, the heap pages are
+         * write-protected at each checkpoint and a page is only saved on the first write fault.
+         * Stores to pages that are already saved run at full speed. The heap is saved in chunks
+         * of the system page size in this mode. Has to be set before the VM is started.
+         */
+        void dirtyPageTracking(bool enabled) {
+            if (enabled && !DirtyPageTracker::supported())
+                throw DirtyPageTrackingNotSupported("Dirty page tracking is not supported on this platform");
+            dirtyPageTracking_ = enabled;
+            if (!enabled)
+                pageTracker_.disarm();
+        }
+
+        bool dirtyPageTracking() const {
+            return dirtyPageTracking_;
+        }
+
+        /**
+         * Starts observing the given heap in the way the current mode requires.
+         */
+        void observe(Heap& heap) {
+            heap.removeObserver(*this);
+            if (!dirtyPageTracking_)
+                heap.attachObserver(*this);
+        }
+
+        uint64_t checkpointInterval() const {
+            return currentCheckpointInterval_;
+        }
+
+        std::size_t memoryLimit() const {
+            return memoryLimit_;
+        }
+
+        std::size_t numberOfCheckpoints() const {
+            return patches_.size();
+        }
+
+        std::size_t memoryUsage() const {
+            if (patches_.empty())
+                return 0;
+            return finishedPatchesMemoryUsage_ + patches_.begin()->second->memoryUsage() + pageTracker_.memoryUsage();
+        }
+
+        bool automaticCheckpointsEnabled() const {
+            return enabled_ && !reconstructing_ && currentCheckpointInterval_ != 0;
+        }
+
+        /**
+         * The instruction counter at which the next automatic checkpoint is due.
+         */
+        const InstructionCounter& nextCheckpoint() const {
+            return nextCheckpoint_;
+        }
+
+        bool needsCheckpoint(const InstructionCounter& counter) const {
+            return automaticCheckpointsEnabled() && counter >= nextCheckpoint_;
         }
 
         MachinePatch& getLastCheckpoint() {
@@ -78,6 +201,7 @@ namespace wasmint {
         }
 
         const MachinePatch& getCheckpoint(const InstructionCounter& counter) {
+            flushDirtyPages();
             auto targetIter = patches_.lower_bound(counter);
             if (targetIter == patches_.end()) {
                 throw NoCheckpointAvailable("No checkpoint available for counter " + counter.toString());
@@ -86,10 +210,7 @@ namespace wasmint {
             }
         }
 
-        void addCheckpoint(VMState & machine) {
-            enabled_ = true;
-            patches_[machine.instructionCounter()] = new MachinePatch(machine);
-        }
+        void addCheckpoint(VMState & machine);
 
         virtual void preChanged(const Heap& heap, const Interval& changedInterval) override {
             if (enabled_ && !reconstructing_) {
@@ -97,8 +218,20 @@ namespace wasmint {
             }
         }
 
-        uint64_t getNativeFunctionReturnValue(const InstructionCounter& counter) {
-            return nativeFunctionReturnValues_[counter];
+        uint64_t getNativeFunctionReturnValue(const InstructionCounter& counter) const {
+            auto iter = nativeFunctionReturnValues_.find(counter);
+            if (iter == nativeFunctionReturnValues_.end())
+                return 0;
+            return iter->second;
+        }
+
+        /**
+         * True if a native function returned a value at a counter in [start, end).
+         */
+        bool hasNativeFunctionReturnValues(const InstructionCounter& start, const InstructionCounter& end) const {
+            // the map is sorted inversely, so the search starts at the newest counter
+            auto iter = nativeFunctionReturnValues_.upper_bound(end);
+            return iter != nativeFunctionReturnValues_.end() && iter->first.counter >= start;
         }
 
         void addNativeFunctionReturnValue(const InstructionCounter& counter, uint64_t value) {
@@ -106,43 +239,22 @@ namespace wasmint {
                 nativeFunctionReturnValues_[counter] = value;
         }
 
-        void setToState(const InstructionCounter& targetCounter, VMState& state) {
-            if (!enabled_)
-                throw HistoryNotEnabled("History recording was not enabled. Can't use setToState()");
-            if (targetCounter == state.instructionCounter()) {
-                // nothing to do here
-                return;
-            }
-            if (targetCounter > latestStateCounter_) {
-                throw TargetStateInTheFuture("Target state is behind the last recorded state");
-            }
-            if (targetCounter < state.instructionCounter()) {
-                auto targetIter = patches_.lower_bound(targetCounter);
-                if (targetIter == patches_.end()) {
-                    throw TargetStateNotInHistory("Can't rollback back to state with counter " + targetCounter.toString());
-                } else {
-                    auto startIter = patches_.upper_bound(state.instructionCounter());
-                    if (startIter == patches_.end()) {
-                        throw TargetStateNotInHistory("Can't rollback back to state with counter " + targetCounter.toString());
-                    } else {
-                        for (;startIter != targetIter; ++startIter) {
-                            startIter->second->apply(state);
-                        }
-                        targetIter->second->apply(state);
-                    }
-                }
-            }
+        void setToState(const InstructionCounter& targetCounter, VMState& state);
 
-            reconstructing_ = true;
-            while (state.instructionCounter() < targetCounter) {
-                if (!state.step()) {
-                    if (state.instructionCounter() != targetCounter) {
-                        throw TargetStateNotInHistory("Target state can't be reached (thread has finished)");
-                    }
-                }
-            }
-            reconstructing_ = false;
-        }
+        /**
+         * Sets the state to the last position before its current counter at which the execution
+         * stopped at a breakpoint or watchpoint. The checkpoint intervals are replayed from the
+         * newest to the oldest one without calling the handlers. Returns false and leaves the state
+         * unchanged if there is no such position.
+         */
+        bool reverseContinue(VMState& state);
+
+        /**
+         * Applies the patches to the given state until it is at the start of the checkpoint that
+         * contains the target counter. Doesn't modify the history, so several states can be rolled
+         * back in parallel. The patches have to be complete, see getCheckpoint().
+         */
+        void rollback(const InstructionCounter& targetCounter, VMState& state) const;
 
         void threadStackShrinked(VMThread& thread) {
             if (enabled_ && !reconstructing_)
@@ -153,8 +265,17 @@ namespace wasmint {
             return reconstructing_;
         }
 
+        /**
+         * Marks that states are replayed outside of setToState(), so the replayed instructions
+         * use the recorded return values of native functions and aren't recorded again.
+         */
+        void reconstructing(bool value) {
+            reconstructing_ = value;
+        }
+
         void latestStateCounter(const InstructionCounter& newCounter) {
-            latestStateCounter_ = newCounter;
+            if (enabled_)
+                latestStateCounter_ = newCounter;
         }
     };
 }
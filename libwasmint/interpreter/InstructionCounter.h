@@ -43,6 +43,11 @@ namespace wasmint {
             return *this;
         }
 
+        InstructionCounter& operator+=(uint64_t value) {
+            counter_ += value;
+            return *this;
+        }
+
         InstructionCounter& operator--() {
             counter_--;
             return *this;
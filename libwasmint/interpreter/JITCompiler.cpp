@@ -38,8 +38,8 @@
 void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* instruction) {
 
     instructionStartAddresses[instruction] = code_.size();
-    // check that each operation is word aligned
-    assert(code_.size() % 4 == 0);
+    // check that each operation is aligned as required by the used encoding
+    assert(code_.size() % ByteCode::instructionAlignment == 0);
 
     switch (instruction->id()) {
         Op2Case(I32Add)
@@ -165,81 +165,81 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
         case InstructionId::I32Load8Signed:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I32Load8Signed);
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Load8Signed*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Load8Signed*>(instruction)->offset());
             break;
         case InstructionId::I32Load8Unsigned:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I32Load8Unsigned);
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Load8Unsigned*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Load8Unsigned*>(instruction)->offset());
             break;
         case InstructionId::I32Load16Signed:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I32Load16Signed);
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Load16Signed*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Load16Signed*>(instruction)->offset());
             break;
         case InstructionId::I32Load16Unsigned:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I32Load16Unsigned);
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Load16Unsigned*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Load16Unsigned*>(instruction)->offset());
             break;
         case InstructionId::I32Load:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I32Load);
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Load*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Load*>(instruction)->offset());
             break;
         case InstructionId::I64Load8Signed:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load8Signed);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load8Signed*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load8Signed*>(instruction)->offset());
             break;
         case InstructionId::I64Load8Unsigned:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load8Unsigned);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load8Unsigned*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load8Unsigned*>(instruction)->offset());
             break;
         case InstructionId::I64Load16Signed:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load16Signed);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load16Signed*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load16Signed*>(instruction)->offset());
             break;
         case InstructionId::I64Load16Unsigned:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load16Unsigned);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load16Unsigned*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load16Unsigned*>(instruction)->offset());
             break;
         case InstructionId::I64Load32Signed:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load32Signed);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load32Signed*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load32Signed*>(instruction)->offset());
             break;
         case InstructionId::I64Load32Unsigned:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load32Unsigned);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load32Unsigned*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load32Unsigned*>(instruction)->offset());
             break;
         case InstructionId::I64Load:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::I64Load);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Load*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Load*>(instruction)->offset());
             break;
         case InstructionId::F32Load:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::F32Load);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::F32Load*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::F32Load*>(instruction)->offset());
             break;
         case InstructionId::F64Load:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::F64Load);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::F64Load*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::F64Load*>(instruction)->offset());
             break;
 
         case InstructionId::I32Store8:
@@ -247,84 +247,81 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I32Store8);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Store8*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Store8*>(instruction)->offset());
             break;
         case InstructionId::I32Store16:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I32Store16);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Store16*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Store16*>(instruction)->offset());
             break;
         case InstructionId::I32Store:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I32Store);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I32Store*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I32Store*>(instruction)->offset());
             break;
         case InstructionId::I64Store8:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I64Store8);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Store8*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Store8*>(instruction)->offset());
             break;
         case InstructionId::I64Store16:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I64Store16);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Store16*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Store16*>(instruction)->offset());
             break;
         case InstructionId::I64Store32:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I64Store32);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Store32*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Store32*>(instruction)->offset());
             break;
         case InstructionId::I64Store:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::I64Store);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::I64Store*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::I64Store*>(instruction)->offset());
             break;
         case InstructionId::F32Store:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::F32Store);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::F32Store*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::F32Store*>(instruction)->offset());
             break;
         case InstructionId::F64Store:
             compileInstruction(instruction->children().at(0));
             compileInstruction(instruction->children().at(1));
             code_.appendOpcode(ByteOpcodes::F64Store);
 
-            code_.append<uint32_t>(dynamic_cast<const wasm_module::F64Store*>(instruction)->offset());
+            code_.appendImmediate(dynamic_cast<const wasm_module::F64Store*>(instruction)->offset());
             break;
 
         case InstructionId::GetLocal:
             code_.appendOpcode(ByteOpcodes::GetLocal);
 
-            code_.append<uint16_t>((uint16_t) dynamic_cast<const wasm_module::GetLocal*>(instruction)->localIndex);
-            code_.append<uint16_t>(0); // alignment
+            code_.appendImmediate(dynamic_cast<const wasm_module::GetLocal*>(instruction)->localIndex);
             break;
         case InstructionId::SetLocal:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::SetLocal);
 
-            code_.append<uint16_t>((uint16_t) dynamic_cast<const wasm_module::SetLocal*>(instruction)->localIndex);
-            code_.append<uint16_t>(0); // alignment
+            code_.appendImmediate(dynamic_cast<const wasm_module::SetLocal*>(instruction)->localIndex);
             break;
         case InstructionId::TeeLocal:
             compileInstruction(instruction->children().at(0));
             code_.appendOpcode(ByteOpcodes::TeeLocal);
 
-            code_.append<uint16_t>((uint16_t) dynamic_cast<const wasm_module::TeeLocal*>(instruction)->localIndex);
-            code_.append<uint16_t>(0); // alignment
+            code_.appendImmediate(dynamic_cast<const wasm_module::TeeLocal*>(instruction)->localIndex);
             break;
         case InstructionId::I32Const:
             code_.appendOpcode(ByteOpcodes::I32Const);
@@ -373,11 +370,9 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
             for (std::size_t i = 0; i < instruction->children().size(); i++)
                 compileInstruction(instruction->children()[i]);
             code_.appendOpcode(ByteOpcodes::Nop);
-            code_.append<uint16_t>(0);
             break;
         case InstructionId::Unreachable:
             code_.appendOpcode(ByteOpcodes::Unreachable);
-            code_.append<uint16_t>(0);
             break;
 
         case InstructionId::CallIndirect:
@@ -388,11 +383,10 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
             const wasm_module::CallIndirect* call = dynamic_cast<const wasm_module::CallIndirect*>(instruction);
 
             code_.appendOpcode(ByteOpcodes::CallIndirect);
-            code_.append<uint16_t>((uint16_t) call->functionType().index());
-            code_.append<uint16_t>((uint16_t) (call->childrenTypes().size() - 1));
+            code_.appendImmediate((uint32_t) call->functionType().index());
+            code_.appendImmediate((uint32_t) (call->childrenTypes().size() - 1));
             // nop that will trigger when we return (just for the debugger)
             code_.appendOpcode(ByteOpcodes::Nop);
-            code_.append<uint16_t>(0);
             break;
         }
         case InstructionId::CallImport:
@@ -402,28 +396,27 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
 
             const wasm_module::CallImport* call = dynamic_cast<const wasm_module::CallImport*>(instruction);
 
-            code_.appendOpcode(ByteOpcodes::Call);
+            code_.appendOpcode(ByteOpcodes::CallImport);
             needsFunctionIndex.push_back(std::make_pair(call->functionSignature, code_.size()));
             code_.append<uint32_t>(0);
-            code_.append<uint32_t>((uint32_t) instruction->children().size());
+            code_.appendImmediate((uint32_t) instruction->children().size());
             for (std::size_t i = 0; i < instruction->children().size(); i++) {
                 const wasm_module::Type* type = instruction->children().at(i)->returnType();
                 if (type == wasm_module::Int32::instance()) {
-                    code_.append<uint32_t>(0);
+                    code_.appendImmediate(0);
                 } else if (type == wasm_module::Int64::instance()) {
-                    code_.append<uint32_t>(1);
+                    code_.appendImmediate(1);
                 } else if (type == wasm_module::Float32::instance()) {
-                    code_.append<uint32_t>(2);
+                    code_.appendImmediate(2);
                 } else if (type == wasm_module::Float64::instance()) {
-                    code_.append<uint32_t>(3);
+                    code_.appendImmediate(3);
                 } else if (type == wasm_module::Void::instance()) {
                     // void arguments will result in crash
-                    code_.append<uint32_t>(4);
+                    code_.appendImmediate(4);
                 }
             }
             // nop that will trigger when we return (just for the debugger)
             code_.appendOpcode(ByteOpcodes::Nop);
-            code_.append<uint16_t>(0);
             break;
         }
         case InstructionId::Call:
@@ -436,10 +429,9 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
             code_.appendOpcode(ByteOpcodes::Call);
             needsFunctionIndex.push_back(std::make_pair(call->functionSignature, code_.size()));
             code_.append<uint32_t>(0);
-            code_.append<uint32_t>((uint32_t) call->childrenTypes().size());
+            code_.appendImmediate((uint32_t) call->childrenTypes().size());
             // nop that will trigger when we return (just for the debugger)
             code_.appendOpcode(ByteOpcodes::Nop);
-            code_.append<uint16_t>(0);
             break;
         }
 
@@ -449,7 +441,7 @@ void wasmint::JITCompiler::compileInstruction(const wasm_module::Instruction* in
             code_.appendOpcode(ByteOpcodes::TableSwitch);
 
             const wasm_module::TableSwitch* tableSwitch = dynamic_cast<const wasm_module::TableSwitch*>(instruction);
-            code_.append<uint32_t>((uint32_t) tableSwitch->targets().size());
+            code_.appendImmediate((uint32_t) tableSwitch->targets().size());
 
             for (const wasm_module::TableSwitchTarget& target : tableSwitch->targets()) {
                 if (target.isCase()) {
@@ -622,17 +614,10 @@ void wasmint::JITCompiler::linkGlobally(WasmintVM* registerMachine) {
     for (auto pair : needsFunctionIndex) {
         auto& signature = pair.first;
 
-        bool foundFunction = false;
-
-        for (uint32_t i = 0; i < registerMachine->getNumberOfCompiledFunction(); i++) {
-            const wasm_module::Function& function = registerMachine->getCompiledFunction(i).function();
-            if (signature.moduleName() == function.moduleName() && signature.name() == function.name()) {
-                code_.write<uint32_t>(pair.second, i);
-                foundFunction = true;
-                break;
-            }
-        }
-        if (!foundFunction) {
+        std::size_t index;
+        if (registerMachine->findIndex(signature.moduleName(), signature.name(), index)) {
+            code_.write<uint32_t>(pair.second, (uint32_t) index);
+        } else {
             throw std::domain_error("Can't find link target " + signature.toString());
         }
     }
@@ -661,7 +646,6 @@ void wasmint::JITCompiler::compile(const wasm_module::Function* function) {
         code_.append<uint16_t>((uint16_t) function->locals().size());
         compileInstruction(function->mainInstruction());
         code_.appendOpcode(ByteOpcodes::End);
-        code_.append<uint16_t>(0);
         linkLocally();
     }
 }
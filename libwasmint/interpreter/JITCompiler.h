@@ -64,6 +64,10 @@ namespace wasmint {
             return code_;
         }
 
+        ByteCode& code() {
+            return code_;
+        }
+
         void linkGlobally(WasmintVM* registerMachine);
 
         const wasm_module::Instruction* getInstruction(uint32_t address) const {
@@ -75,6 +79,23 @@ namespace wasmint {
             }
         }
 
+        /**
+         * The innermost instruction whose bytecode contains the given address. As the children
+         * are compiled before their parents, this is the first instruction that finishes behind it.
+         */
+        const wasm_module::Instruction* instructionAt(uint32_t address) const {
+            auto iter = instructionFinishedAddresses.upper_bound(address);
+            if (iter != instructionFinishedAddresses.end()) {
+                return iter->second;
+            } else {
+                return nullptr;
+            }
+        }
+
+        bool hasCompiled(const wasm_module::Instruction* instruction) const {
+            return instructionEndAddresses.find(instruction) != instructionEndAddresses.end();
+        }
+
         uint32_t getInstructionEndAddress(const wasm_module::Instruction* instruction) const {
             auto iter = instructionEndAddresses.find(instruction);
             if (iter != instructionEndAddresses.end()) {
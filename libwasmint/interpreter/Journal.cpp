@@ -0,0 +1,127 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "Journal.h"
+#include <algorithm>
+
+namespace wasmint {
+
+    const char Journal::magic_[8] = {'w', 'a', 's', 'm', 'j', 'r', 'n', 'l'};
+    const uint32_t Journal::version_;
+
+    void Journal::writeVarUInt(uint64_t value) {
+        do {
+            uint8_t byte = value & 0x7Fu;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0x80u;
+            output_.put((char) byte);
+        } while (value != 0);
+    }
+
+    bool Journal::readVarUInt(std::istream& input, uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            int byte = input.get();
+            if (byte == std::char_traits<char>::eof())
+                return false;
+            value |= ((uint64_t) (byte & 0x7F)) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    void Journal::record(const std::string& path) {
+        close();
+        output_.open(path, std::ios::binary | std::ios::trunc);
+        if (!output_)
+            throw JournalNotAccessible("Can't create journal " + path);
+
+        output_.write(magic_, sizeof(magic_));
+        for (unsigned i = 0; i < 4; i++) {
+            output_.put((char) ((version_ >> (i * 8)) & 0xFFu));
+        }
+        mode_ = Mode::Record;
+        path_ = path;
+    }
+
+    void Journal::replay(const std::string& path) {
+        close();
+        std::ifstream input(path, std::ios::binary);
+        if (!input)
+            throw JournalNotAccessible("Can't read journal " + path);
+
+        char magic[sizeof(magic_)];
+        input.read(magic, sizeof(magic));
+        if (!input || !std::equal(magic, magic + sizeof(magic), magic_))
+            throw InvalidJournal(path + " is not a wasmint journal");
+        uint32_t version = 0;
+        for (unsigned i = 0; i < 4; i++) {
+            int byte = input.get();
+            if (byte == std::char_traits<char>::eof())
+                throw InvalidJournal(path + " is not a wasmint journal");
+            version |= ((uint32_t) (byte & 0xFF)) << (i * 8);
+        }
+        if (version != version_)
+            throw InvalidJournal("Journal " + path + " has unsupported version " + std::to_string(version));
+
+        uint64_t counter = 0;
+        uint64_t distance;
+        while (readVarUInt(input, distance)) {
+            uint64_t value;
+            if (!readVarUInt(input, value))
+                throw InvalidJournal("Journal " + path + " ends in the middle of an entry");
+            counter += distance;
+            returnValues_[counter] = value;
+            entryCount_++;
+        }
+        if (!input.eof())
+            throw InvalidJournal("Journal " + path + " contains an invalid entry");
+
+        mode_ = Mode::Replay;
+        path_ = path;
+    }
+
+    void Journal::close() {
+        if (mode_ == Mode::Record)
+            output_.close();
+        mode_ = Mode::Off;
+        path_.clear();
+        lastCounter_ = 0;
+        entryCount_ = 0;
+        returnValues_.clear();
+    }
+
+    void Journal::addNativeFunctionReturnValue(const InstructionCounter& counter, uint64_t value) {
+        if (entryCount_ != 0 && counter.toUint64() <= lastCounter_)
+            throw JournalMismatch("Journal can only record a single forward execution, but got a native call at "
+                                  + counter.toString() + " after one at " + std::to_string(lastCounter_));
+        writeVarUInt(counter.toUint64() - lastCounter_);
+        writeVarUInt(value);
+        lastCounter_ = counter.toUint64();
+        entryCount_++;
+    }
+
+    uint64_t Journal::getNativeFunctionReturnValue(const InstructionCounter& counter) const {
+        auto iter = returnValues_.find(counter.toUint64());
+        if (iter == returnValues_.end())
+            throw JournalMismatch("Journal " + path_ + " contains no native call at " + counter.toString());
+        return iter->second;
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_JOURNAL_H
+#define WASMINT_JOURNAL_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <ExceptionWithMessage.h>
+#include "InstructionCounter.h"
+
+namespace wasmint {
+
+    ExceptionMessage(JournalNotAccessible)
+    ExceptionMessage(InvalidJournal)
+    ExceptionMessage(JournalMismatch)
+
+    /**
+     * Log of all nondeterministic inputs of an execution, which are the return values of the native
+     * functions. In record mode every value is appended to a file, in replay mode the native functions
+     * aren't called and the values are taken from a previously recorded file instead. This allows to
+     * reproduce an execution offline without the host that provided the native functions.
+     *
+     * The file starts with a magic string and version, followed by one entry per native call:
+     * the distance in instructions to the previous entry and the value, both as unsigned LEB128.
+     */
+    class Journal {
+    public:
+        enum class Mode {
+            Off,
+            Record,
+            Replay
+        };
+
+    private:
+        static const char magic_[8];
+        static const uint32_t version_ = 1;
+
+        Mode mode_ = Mode::Off;
+        std::ofstream output_;
+        std::string path_;
+
+        // counter of the last written entry
+        uint64_t lastCounter_ = 0;
+        uint64_t entryCount_ = 0;
+
+        std::map<uint64_t, uint64_t> returnValues_;
+
+        void writeVarUInt(uint64_t value);
+
+        static bool readVarUInt(std::istream& input, uint64_t& value);
+
+    public:
+        Journal() {
+        }
+
+        ~Journal() {
+            close();
+        }
+
+        Journal(const Journal&) = delete;
+        Journal& operator=(const Journal&) = delete;
+
+        /**
+         * Starts recording into a new file at the given path. Throws JournalNotAccessible if the file
+         * can't be created.
+         */
+        void record(const std::string& path);
+
+        /**
+         * Reads the file at the given path and replays its values from now on. Throws
+         * JournalNotAccessible if the file can't be read and InvalidJournal if it isn't a journal.
+         */
+        void replay(const std::string& path);
+
+        /**
+         * Flushes the recorded values and stops recording or replaying.
+         */
+        void close();
+
+        void flush() {
+            if (mode_ == Mode::Record)
+                output_.flush();
+        }
+
+        Mode mode() const {
+            return mode_;
+        }
+
+        bool recording() const {
+            return mode_ == Mode::Record;
+        }
+
+        bool replaying() const {
+            return mode_ == Mode::Replay;
+        }
+
+        const std::string& path() const {
+            return path_;
+        }
+
+        /**
+         * Number of recorded or loaded values.
+         */
+        uint64_t entryCount() const {
+            return entryCount_;
+        }
+
+        /**
+         * Appends the value that a native function returned at the given counter. The counters
+         * have to increase, as a journal only records a single forward execution.
+         */
+        void addNativeFunctionReturnValue(const InstructionCounter& counter, uint64_t value);
+
+        /**
+         * The recorded value of the native function called at the given counter. Throws
+         * JournalMismatch if the journal contains no call at this counter.
+         */
+        uint64_t getNativeFunctionReturnValue(const InstructionCounter& counter) const;
+    };
+}
+
+#endif //WASMINT_JOURNAL_H
@@ -37,8 +37,8 @@ namespace wasmint {
         MachinePatch() {
         }
 
-        MachinePatch(VMState& machine)
-                : heapPatch_(machine.heap()),
+        MachinePatch(VMState& machine, std::size_t heapChunkSize = HeapPatch::defaultChunkSize)
+                : heapPatch_(machine.heap(), heapChunkSize),
                   threadPatch_(machine.thread()),
                   startCounter_(machine.instructionCounter()) {
         }
@@ -69,9 +69,26 @@ namespace wasmint {
             return influencedByExternalState_;
         }
 
+        /**
+         * Merges the patch that was recorded directly after this one into this patch.
+         */
+        void merge(const MachinePatch& newerPatch) {
+            heapPatch_.merge(newerPatch.heapPatch_);
+            threadPatch_.merge(newerPatch.threadPatch_);
+            influencedByExternalState_ = influencedByExternalState_ || newerPatch.influencedByExternalState_;
+        }
+
+        std::size_t memoryUsage() const {
+            return sizeof(MachinePatch) + heapPatch_.memoryUsage() + threadPatch_.memoryUsage();
+        }
+
         const HeapPatch& heapPatch() const {
             return heapPatch_;
         }
+
+        HeapPatch& heapPatch() {
+            return heapPatch_;
+        }
     };
 }
 
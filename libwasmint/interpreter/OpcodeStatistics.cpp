@@ -0,0 +1,120 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "OpcodeStatistics.h"
+#include <Module.h>
+#include <algorithm>
+#include <map>
+
+namespace wasmint {
+
+    const std::size_t OpcodeStatistics::numberOfOpcodes;
+
+    namespace {
+        std::string functionName(const wasm_module::Function& function) {
+            return function.module().name() + "." + function.name();
+        }
+
+        std::string jsonString(const std::string& value) {
+            std::string result = "\"";
+            for (char c : value) {
+                if (c == '"' || c == '\\')
+                    result += '\\';
+                result += c;
+            }
+            return result + "\"";
+        }
+
+        // the functions sorted by name so the output doesn't depend on their addresses
+        std::map<std::string, uint64_t> functionsByName(
+                const std::unordered_map<const wasm_module::Function*, uint64_t>& functions) {
+            std::map<std::string, uint64_t> result;
+            for (const auto& entry : functions) {
+                result[functionName(*entry.first)] += entry.second;
+            }
+            return result;
+        }
+    }
+
+    void OpcodeStatistics::clear() {
+        std::fill(opcodes_.begin(), opcodes_.end(), 0);
+        std::fill(pairs_.begin(), pairs_.end(), 0);
+        functions_.clear();
+        previousOpcode_ = numberOfOpcodes;
+        lastFunction_ = nullptr;
+        lastFunctionCount_ = nullptr;
+    }
+
+    uint64_t OpcodeStatistics::functionCount(const wasm_module::Function& function) const {
+        auto iter = functions_.find(&function);
+        return iter == functions_.end() ? 0 : iter->second;
+    }
+
+    uint64_t OpcodeStatistics::totalCount() const {
+        uint64_t result = 0;
+        for (uint64_t count : opcodes_) {
+            result += count;
+        }
+        return result;
+    }
+
+    void OpcodeStatistics::writeCsv(std::ostream& output) const {
+        output << "kind,name,count\n";
+        for (std::size_t opcode = 0; opcode < numberOfOpcodes; opcode++) {
+            if (opcodes_[opcode] != 0)
+                output << "opcode," << ByteOpcodes::name((ByteOpcodes::Values) opcode) << "," << opcodes_[opcode] << "\n";
+        }
+        for (std::size_t index = 0; index < pairs_.size(); index++) {
+            if (pairs_[index] != 0) {
+                output << "pair," << ByteOpcodes::name((ByteOpcodes::Values) (index / numberOfOpcodes)) << ">"
+                       << ByteOpcodes::name((ByteOpcodes::Values) (index % numberOfOpcodes)) << "," << pairs_[index] << "\n";
+            }
+        }
+        for (const auto& entry : functionsByName(functions_)) {
+            output << "function," << entry.first << "," << entry.second << "\n";
+        }
+    }
+
+    void OpcodeStatistics::writeJson(std::ostream& output) const {
+        output << "{\n  \"opcodes\": {";
+        const char* separator = "\n    ";
+        for (std::size_t opcode = 0; opcode < numberOfOpcodes; opcode++) {
+            if (opcodes_[opcode] != 0) {
+                output << separator << jsonString(ByteOpcodes::name((ByteOpcodes::Values) opcode)) << ": " << opcodes_[opcode];
+                separator = ",\n    ";
+            }
+        }
+        output << "\n  },\n  \"pairs\": {";
+        separator = "\n    ";
+        for (std::size_t index = 0; index < pairs_.size(); index++) {
+            if (pairs_[index] != 0) {
+                output << separator << jsonString(ByteOpcodes::name((ByteOpcodes::Values) (index / numberOfOpcodes)) + ">"
+                                                  + ByteOpcodes::name((ByteOpcodes::Values) (index % numberOfOpcodes)))
+                       << ": " << pairs_[index];
+                separator = ",\n    ";
+            }
+        }
+        output << "\n  },\n  \"functions\": {";
+        separator = "\n    ";
+        for (const auto& entry : functionsByName(functions_)) {
+            output << separator << jsonString(entry.first) << ": " << entry.second;
+            separator = ",\n    ";
+        }
+        output << "\n  }\n}\n";
+    }
+}
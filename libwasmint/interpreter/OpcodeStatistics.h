@@ -0,0 +1,102 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_OPCODESTATISTICS_H
+#define WASMINT_OPCODESTATISTICS_H
+
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include <Function.h>
+#include "ByteOpcodes.h"
+
+namespace wasmint {
+
+    /**
+     * Counts how often each opcode and each pair of consecutive opcodes is executed by the
+     * interpreter, as well as the executed opcodes per function. Only collected in builds with
+     * WASMINT_OPCODE_STATS, which adds a call to count() in front of every opcode. Native code
+     * doesn't count its instructions, so native execution should be disabled while collecting.
+     * Instructions that are replayed from the history, e.g. by stepBack() or the halting problem
+     * detector, are not counted. The counters aren't synchronized, so only one thread may count.
+     */
+    class OpcodeStatistics {
+    public:
+        static const std::size_t numberOfOpcodes = ByteOpcodes::Breakpoint + 1;
+
+    private:
+        std::vector<uint64_t> opcodes_;
+        // indexed by previous opcode * numberOfOpcodes + opcode
+        std::vector<uint64_t> pairs_;
+        std::unordered_map<const wasm_module::Function*, uint64_t> functions_;
+
+        std::size_t previousOpcode_ = numberOfOpcodes;
+        // cached entry of the function that executed the last opcode
+        const wasm_module::Function* lastFunction_ = nullptr;
+        uint64_t* lastFunctionCount_ = nullptr;
+
+    public:
+        OpcodeStatistics() : opcodes_(numberOfOpcodes, 0), pairs_(numberOfOpcodes * numberOfOpcodes, 0) {
+        }
+
+        void count(std::size_t opcode, const wasm_module::Function& function) {
+            // a breakpoint is either not executed at all or continues with the original opcode
+            if (opcode == ByteOpcodes::Breakpoint)
+                return;
+            opcodes_[opcode]++;
+            if (previousOpcode_ != numberOfOpcodes)
+                pairs_[previousOpcode_ * numberOfOpcodes + opcode]++;
+            previousOpcode_ = opcode;
+
+            if (&function != lastFunction_) {
+                lastFunction_ = &function;
+                lastFunctionCount_ = &functions_[&function];
+            }
+            (*lastFunctionCount_)++;
+        }
+
+        void clear();
+
+        uint64_t opcodeCount(ByteOpcodes::Values opcode) const {
+            return opcodes_[opcode];
+        }
+
+        uint64_t pairCount(ByteOpcodes::Values first, ByteOpcodes::Values second) const {
+            return pairs_[first * numberOfOpcodes + second];
+        }
+
+        uint64_t functionCount(const wasm_module::Function& function) const;
+
+        uint64_t totalCount() const;
+
+        /**
+         * Writes one "kind,name,count" line per opcode, pair and function that was executed,
+         * where kind is opcode, pair or function. Pairs are named "First>Second".
+         */
+        void writeCsv(std::ostream& output) const;
+
+        /**
+         * Writes an object with the members opcodes, pairs and functions that map the names
+         * to the counts like writeCsv().
+         */
+        void writeJson(std::ostream& output) const;
+    };
+}
+
+#endif //WASMINT_OPCODESTATISTICS_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_STATEHASH_H
+#define WASMINT_STATEHASH_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace wasmint {
+
+    /**
+     * Helpers for hashing the state of the VM. The hashes are only used to find candidates
+     * for identical states quickly, so equal hashes still have to be confirmed by comparing
+     * the states.
+     */
+    namespace StateHash {
+
+        // the finalizer of splitmix64
+        inline uint64_t mix(uint64_t value) {
+            value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+            return value ^ (value >> 31);
+        }
+
+        inline uint64_t combine(uint64_t hash, uint64_t value) {
+            return mix(hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2)));
+        }
+
+        inline uint64_t combine(uint64_t hash, const uint64_t* values, std::size_t size) {
+            for (std::size_t i = 0; i < size; i++) {
+                hash = combine(hash, values[i]);
+            }
+            return hash;
+        }
+    }
+}
+
+#endif //WASMINT_STATEHASH_H
@@ -55,6 +55,27 @@ namespace wasmint {
             }
         }
 
+        /**
+         * Merges the patch that was recorded directly after this one into this patch.
+         * Afterwards this patch restores the thread from the end of the newer patch.
+         */
+        void merge(const ThreadPatch& newerPatch) {
+            // The frames below our smallest saved frame weren't touched before the newer patch
+            // started, so the newer patch contains their old state.
+            while (smallestSavedFrameIndex > newerPatch.smallestSavedFrameIndex) {
+                smallestSavedFrameIndex--;
+                savedFrames_.push_back(newerPatch.savedFrames_.at(newerPatch.stackSize - 1 - smallestSavedFrameIndex));
+            }
+        }
+
+        std::size_t memoryUsage() const {
+            std::size_t result = sizeof(ThreadPatch);
+            for (const FunctionFrame& frame : savedFrames_) {
+                result += frame.memoryUsage();
+            }
+            return result;
+        }
+
         void applyPatch(VMThread& thread) const {
             thread.frames_.resize(stackSize);
             std::size_t j = savedFrames_.size() - 1;
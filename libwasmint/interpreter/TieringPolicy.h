@@ -0,0 +1,66 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_TIERINGPOLICY_H
+#define WASMINT_TIERINGPOLICY_H
+
+#include <cstdint>
+
+namespace wasmint {
+
+    /**
+     * Decides when a function is promoted from the bytecode interpreter to native code.
+     *
+     * A function is hot once it was called callThreshold times or once its loops took
+     * backEdgeThreshold backward branches in total. Functions that never get hot are never
+     * compiled, so short running or cold code only pays for the bytecode compilation.
+     */
+    class TieringPolicy {
+
+        uint32_t callThreshold_ = 10;
+        uint32_t backEdgeThreshold_ = 1000;
+
+    public:
+        TieringPolicy() {
+        }
+
+        TieringPolicy(uint32_t callThreshold, uint32_t backEdgeThreshold)
+                : callThreshold_(callThreshold), backEdgeThreshold_(backEdgeThreshold) {
+        }
+
+        /**
+         * A policy that compiles every function before it executes its first instruction.
+         */
+        static TieringPolicy eager() {
+            return TieringPolicy(0, 0);
+        }
+
+        uint32_t callThreshold() const {
+            return callThreshold_;
+        }
+
+        uint32_t backEdgeThreshold() const {
+            return backEdgeThreshold_;
+        }
+
+        bool isHot(uint32_t calls, uint32_t backEdges) const {
+            return calls >= callThreshold_ || backEdges >= backEdgeThreshold_;
+        }
+    };
+}
+
+#endif //WASMINT_TIERINGPOLICY_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_VMSNAPSHOT_H
+#define WASMINT_VMSNAPSHOT_H
+
+#include <interpreter/heap/HeapSnapshot.h>
+#include "VMState.h"
+
+namespace wasmint {
+
+    /**
+     * A snapshot of a VMState. The heap is shared copy-on-write with the state, so taking
+     * a snapshot only costs as much as the chunks that are modified afterwards. The thread
+     * is copied as its size only depends on the call depth and not on the heap size.
+     */
+    class VMSnapshot {
+
+        HeapSnapshot heap_;
+        VMThread thread_;
+        InstructionCounter instructionCounter_;
+
+    public:
+        VMSnapshot(VMState& state)
+                : heap_(state.heap()), thread_(state.thread()), instructionCounter_(state.instructionCounter()) {
+        }
+
+        /**
+         * Sets the given state to the state of this snapshot.
+         */
+        void restore(VMState& state) const {
+            heap_.restore(state.heap());
+            state.thread() = thread_;
+            state.instructionCounter(instructionCounter_);
+        }
+
+        const HeapSnapshot& heap() const {
+            return heap_;
+        }
+
+        const VMThread& thread() const {
+            return thread_;
+        }
+
+        const InstructionCounter& instructionCounter() const {
+            return instructionCounter_;
+        }
+
+        bool operator==(const VMState& state) const {
+            return instructionCounter_ == state.instructionCounter()
+                   && thread_ == state.thread()
+                   && heap_ == state.heap();
+        }
+
+        bool operator!=(const VMState& state) const {
+            return !(*this == state);
+        }
+    };
+}
+
+#endif //WASMINT_VMSNAPSHOT_H
@@ -27,6 +27,7 @@
 #include "VMThread.h"
 #include "CompiledFunction.h"
 #include <stdexcept>
+#include <limits>
 
 namespace wasmint {
 
@@ -38,6 +39,43 @@ namespace wasmint {
         InstructionCounter instructionCounter_;
         VMThread thread_;
 
+        // continuing at the counter at which the thread stopped at a breakpoint passes this breakpoint
+        InstructionCounter breakpointCounter_;
+        bool stoppedAtBreakpoint_ = false;
+
+        void enableBreakpoints() {
+            thread_.stopAtBreakpoints(true);
+            thread_.passBreakpoint(stoppedAtBreakpoint_ && breakpointCounter_ == instructionCounter_);
+            thread_.watchpointHit(false);
+            stoppedAtBreakpoint_ = false;
+        }
+
+        void disableBreakpoints() {
+            thread_.stopAtBreakpoints(false);
+            thread_.passBreakpoint(false);
+        }
+
+        /**
+         * Executes the next instruction unless the thread stops at a breakpoint in front of it.
+         * Returns true if it stopped at a breakpoint or the instruction hit a watchpoint.
+         */
+        bool stepOrStopAtBreakpoint() {
+            ++instructionCounter_;
+            thread_.step(heap_);
+            if (!thread_.breakpointHit()) {
+                if (!thread_.watchpointHit())
+                    return false;
+                thread_.watchpointHit(false);
+                return true;
+            }
+            thread_.breakpointHit(false);
+            // no instruction was executed
+            --instructionCounter_;
+            stoppedAtBreakpoint_ = true;
+            breakpointCounter_ = instructionCounter_;
+            return true;
+        }
+
     public:
         void useModule(wasm_module::Module &module) {
             heap_ = Heap(module.heapData());
@@ -55,6 +93,16 @@ namespace wasmint {
             return thread_;
         }
 
+        /**
+         * Starts the given function in the existing thread. In contrast to the other
+         * startAtFunction methods the parameters are neither checked nor converted.
+         */
+        VMThread& startAtFunction(WasmintVM* vm, std::size_t index, const uint64_t* parameters, std::size_t parameterCount) {
+            thread_.reset(vm);
+            thread_.enterFunction(index, parameters, parameterCount);
+            return thread_;
+        }
+
         bool step() {
             ++instructionCounter_;
             if (!thread_.finished()) {
@@ -64,29 +112,88 @@ namespace wasmint {
             return false;
         }
 
+        /**
+         * Executes the instructions up to the target counter in the interpreter without the
+         * checks for native code and breakpoints of stepUntil(). Used for replaying the history.
+         * Returns false if the thread finished before it reached the target.
+         */
+        bool replayUntil(const InstructionCounter& target) {
+            thread_.stepUntil(heap_, instructionCounter_, target);
+            if (instructionCounter_ < target) {
+                // step() also counts the attempt to step a finished thread
+                ++instructionCounter_;
+                return false;
+            }
+            return true;
+        }
+
         bool stepDebug() {
-            ++instructionCounter_;
             if (!thread_.finished()) {
-                thread_.stepDebug(heap_);
+                enableBreakpoints();
+                stepOrStopAtBreakpoint();
+                disableBreakpoints();
                 return true;
             }
+            ++instructionCounter_;
             return false;
         }
 
         void stepUntilFinished(bool checkBreakpoints = true) {
+            stepUntil(std::numeric_limits<uint64_t>::max(), checkBreakpoints);
+        }
+
+        /**
+         * Steps until the thread finished, a breakpoint was hit or the instruction counter reached
+         * the given limit. Native code only stops at calls and returns, so the counter can end up
+         * behind the limit. Returns true if the execution stopped at a breakpoint.
+         */
+        bool stepUntil(const InstructionCounter& limit, bool checkBreakpoints = true) {
             if (checkBreakpoints) {
-                while (!thread_.finished()) {
-                    ++instructionCounter_;
-                    if (thread_.stepDebug(heap_)) {
-                        break;
+                // the breakpoints are patched into the code, so this is the same loop as below
+                enableBreakpoints();
+                bool stopped = false;
+                while (!stopped && !thread_.finished() && instructionCounter_ < limit) {
+#ifdef WASMINT_NATIVE_JIT
+                    if (thread_.stepNative(heap_, instructionCounter_)) {
+                        // the native code leaves after a store that hit a watchpoint
+                        if (thread_.watchpointHit()) {
+                            thread_.watchpointHit(false);
+                            stopped = true;
+                        }
+                        continue;
                     }
+#endif
+                    stopped = stepOrStopAtBreakpoint();
                 }
+                disableBreakpoints();
+                return stopped;
             } else {
-                while (!thread_.finished()) {
+                while (!thread_.finished() && instructionCounter_ < limit) {
+#ifdef WASMINT_NATIVE_JIT
+                    if (thread_.stepNative(heap_, instructionCounter_))
+                        continue;
+#endif
                     ++instructionCounter_;
                     thread_.step(heap_);
                 }
             }
+            return false;
+        }
+
+        /**
+         * True if the thread stopped in front of a breakpoint at the current counter, so
+         * continuing executes the instruction at the breakpoint.
+         */
+        bool stoppedAtBreakpoint() const {
+            return stoppedAtBreakpoint_ && breakpointCounter_ == instructionCounter_;
+        }
+
+        /**
+         * Marks that the thread stopped in front of the breakpoint at the current position.
+         */
+        void markStoppedAtBreakpoint() {
+            stoppedAtBreakpoint_ = true;
+            breakpointCounter_ = instructionCounter_;
         }
 
         Heap& heap() {
@@ -121,6 +228,15 @@ namespace wasmint {
             return thread_.trapReason();
         }
 
+        /**
+         * Hash of the heap and the thread, but not of the instruction counter, so two states
+         * that only differ in their counter have the same hash. Only needs constant time for
+         * the heap if the heap maintains its hash.
+         */
+        uint64_t stateHash() const {
+            return StateHash::combine(heap_.hash(), thread_.hash());
+        }
+
         bool operator==(const VMState& other) const {
             return instructionCounter_ == other.instructionCounter()
                     && thread_ == other.thread_
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "VMStats.h"
+
+namespace wasmint {
+
+    void VMStats::print(std::ostream& output) const {
+        using std::chrono::microseconds;
+        using std::chrono::duration_cast;
+
+        output << "instructions: " << instructions << "\n"
+               << "direct calls: " << directCalls << "\n"
+               << "indirect calls: " << indirectCalls << "\n"
+               << "native calls: " << nativeCalls << "\n"
+               << "max call depth: " << maxCallDepth << "\n"
+               << "heap size: " << heapSize << "\n"
+               << "heap growths: " << heapGrowths << "\n"
+               << "history bytes: " << historyBytes << "\n"
+               << "parse time us: " << duration_cast<microseconds>(parseTime).count() << "\n"
+               << "compile time us: " << duration_cast<microseconds>(compileTime).count() << "\n"
+               << "link time us: " << duration_cast<microseconds>(linkTime).count() << "\n"
+               << "native compile time us: " << duration_cast<microseconds>(nativeCompileTime).count() << "\n";
+    }
+}
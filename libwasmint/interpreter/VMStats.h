@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_VMSTATS_H
+#define WASMINT_VMSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace wasmint {
+
+    /**
+     * Snapshot of what a WasmintVM did so far, returned by WasmintVM::stats(). The counters are
+     * collected all the time, as they only cost an increment per call. Calls that are replayed
+     * from the history are counted again.
+     */
+    struct VMStats {
+        // instruction counter of the current state
+        uint64_t instructions = 0;
+        // calls of WebAssembly functions via call and call_import
+        uint64_t directCalls = 0;
+        // calls via call_indirect
+        uint64_t indirectCalls = 0;
+        // calls of functions provided by the host
+        uint64_t nativeCalls = 0;
+        // maximum number of frames on the call stack
+        std::size_t maxCallDepth = 0;
+
+        std::size_t heapSize = 0;
+        // successful grow_memory instructions
+        uint64_t heapGrowths = 0;
+        // memory used by the recorded history
+        std::size_t historyBytes = 0;
+
+        // time spent in the phases of loading the modules
+        std::chrono::nanoseconds parseTime{0};
+        std::chrono::nanoseconds compileTime{0};
+        std::chrono::nanoseconds linkTime{0};
+        // time spent compiling hot functions to native code
+        std::chrono::nanoseconds nativeCompileTime{0};
+
+        /**
+         * Writes one "name: value" line per statistic. The times are in microseconds.
+         */
+        void print(std::ostream& output) const;
+    };
+}
+
+#endif //WASMINT_VMSTATS_H
@@ -30,7 +30,6 @@ namespace wasmint {
     }
 
     void VMThread::enterFunction(std::size_t functionId, const std::vector<wasm_module::Variable>& parameters) {
-        frames_.clear();
         CompiledFunction& function = machine().getCompiledFunction(functionId);
         if (function.function().parameters().size() != parameters.size()) {
             throw InvalidCallParameters("Function " + function.function().name() + " takes " +
@@ -44,25 +43,92 @@ namespace wasmint {
                                             + " was given");
             }
         }
-        pushFrame(FunctionFrame(machine().getCompiledFunction(functionId)));
-        for (uint64_t i = 0; i < parameters.size(); i++) {
-            frames_.front().setVariable(i, parameters[i].primitiveValue());
+        std::vector<uint64_t> rawParameters;
+        rawParameters.reserve(parameters.size());
+        for (const wasm_module::Variable& parameter : parameters) {
+            rawParameters.push_back(parameter.primitiveValue());
+        }
+        enterFunction(functionId, rawParameters.data(), rawParameters.size());
+    }
+
+    void VMThread::enterFunction(std::size_t functionId, const uint64_t* parameters, std::size_t parameterCount) {
+        frames_.clear();
+        CompiledFunction& function = machine().getCompiledFunction(functionId);
+        function.countCall();
+        pushFrame(function);
+        traceEnter(function.function());
+        for (std::size_t i = 0; i < parameterCount; i++) {
+            frames_.front().setVariable(i, parameters[i]);
         }
     }
 
+    void VMThread::reset(WasmintVM* machine) {
+        frames_.clear();
+        currentFrame_ = nullptr;
+        trapReason_.clear();
+        finished_ = false;
+        result_ = wasm_module::Variable();
+        machine_ = machine;
+    }
+
+    void VMThread::updateMaxFrameCount() {
+        if (!machine().reconstructing())
+            maxFrameCount_ = frames_.size();
+    }
+
+    void VMThread::countDirectCall() {
+        if (!machine().reconstructing())
+            directCalls_++;
+    }
+
+    void VMThread::countIndirectCall() {
+        if (!machine().reconstructing())
+            indirectCalls_++;
+    }
+
+    void VMThread::countHeapGrowth() {
+        if (!machine().reconstructing())
+            heapGrowths_++;
+    }
+
+    void VMThread::recordNativeFunctionReturnValue(uint64_t value) {
+        machine().history().addNativeFunctionReturnValue(machine().instructionCounter(), value);
+        if (machine().journal().recording())
+            machine().journal().addNativeFunctionReturnValue(machine().instructionCounter(), value);
+    }
+
+    void VMThread::traceEnter(const wasm_module::Function& function) {
+        Tracer* tracer = machine().tracer();
+        if (tracer && !machine().reconstructing())
+            tracer->enter(function);
+    }
+
+    void VMThread::traceExit(const wasm_module::Function& function) {
+        Tracer* tracer = machine().tracer();
+        if (tracer && !machine().reconstructing())
+            tracer->exit(function);
+    }
+
     void VMThread::enterFunction(std::size_t functionId, uint32_t parameterSize) {
         CompiledFunction& targetFunction = machine().getCompiledFunction(functionId);
         const wasm_module::Function& function = targetFunction.function();
 
         if (function.isNative()) {
+            if (!machine().reconstructing())
+                nativeCalls_++;
             auto nativeInstruction = static_cast<const wasm_module::NativeInstruction*>(function.mainInstruction());
 
+            // the parameters are the topmost values on the stack, the first parameter is the deepest one
+            ValueStack& stack = currentFrame_->stack();
+            uint64_t* parameters = stack.top() - parameterSize;
+
             if (machine().reconstructing()) {
                 if (function.variadic()) {
-                    for (uint16_t i = 0; i < parameterSize; i++) {
-                        frames_.back().popFromCode<uint32_t>();
+                    for (uint32_t i = 0; i < parameterSize; i++) {
+                        frames_.back().popImmediate();
                     }
                 }
+                stack.top(parameters);
                 if (nativeInstruction->returnType() != wasm_module::Void::instance()) {
                     currentFrame_->passFunctionResult(machine().history().getNativeFunctionReturnValue(machine().instructionCounter()));
                 }
@@ -72,55 +138,107 @@ namespace wasmint {
                     machine().history().getLastCheckpoint().influencedByExternalState(true);
                 }
 
-                std::vector<wasm_module::Variable> parameters;
-                parameters.reserve(nativeInstruction->childrenTypes().size());
-                for (int32_t i = parameterSize - 1; i >= 0; i++) {
-                    const wasm_module::Type* type = nullptr;
+                traceEnter(function);
+                if (machine().journal().replaying()) {
+                    // the journal replaces the host, so the native function isn't called
                     if (function.variadic()) {
-                        uint32_t typeId = frames_.back().popFromCode<uint32_t>();
-                        switch(typeId) {
-                            case 0:
-                                type = wasm_module::Int32::instance();
-                                break;
-                            case 1:
-                                type = wasm_module::Int64::instance();
-                                break;
-                            case 2:
-                                type = wasm_module::Float32::instance();
-                                break;
-                            case 3:
-                                type = wasm_module::Float64::instance();
-                                break;
-                            default:
-                                assert(false);
+                        for (uint32_t i = 0; i < parameterSize; i++) {
+                            frames_.back().popImmediate();
                         }
-                    } else {
-                        type = function.parameters().at(i);
                     }
-                    wasm_module::Variable parameter(type);
-                    uint64_t value = currentFrame_->pop<uint64_t>();
-                    parameter.setFromPrimitiveValue(value);
-                    parameters.push_back(parameter);
-                }
+                    stack.top(parameters);
+                    if (nativeInstruction->returnType() != wasm_module::Void::instance()) {
+                        uint64_t result = machine().journal().getNativeFunctionReturnValue(machine().instructionCounter());
+                        machine().history().addNativeFunctionReturnValue(machine().instructionCounter(), result);
+                        currentFrame_->passFunctionResult(result);
+                    }
+                } else if (const wasm_module::NativeBinding* binding = nativeInstruction->binding()) {
+                    uint64_t result = binding->call(parameters);
+                    stack.top(parameters);
 
-                wasm_module::Variable result = nativeInstruction->call(parameters);
+                    if (nativeInstruction->returnType() != wasm_module::Void::instance()) {
+                        recordNativeFunctionReturnValue(result);
+                        currentFrame_->passFunctionResult(result);
+                    }
+                } else {
+                    std::vector<wasm_module::Variable> parameterVariables;
+                    parameterVariables.reserve(parameterSize);
+                    for (uint32_t i = 0; i < parameterSize; i++) {
+                        const wasm_module::Type* type = nullptr;
+                        if (function.variadic()) {
+                            uint32_t typeId = frames_.back().popImmediate();
+                            switch(typeId) {
+                                case 0:
+                                    type = wasm_module::Int32::instance();
+                                    break;
+                                case 1:
+                                    type = wasm_module::Int64::instance();
+                                    break;
+                                case 2:
+                                    type = wasm_module::Float32::instance();
+                                    break;
+                                case 3:
+                                    type = wasm_module::Float64::instance();
+                                    break;
+                                default:
+                                    assert(false);
+                            }
+                        } else {
+                            type = function.parameters().at(i);
+                        }
+                        wasm_module::Variable parameter(type);
+                        parameter.setFromPrimitiveValue(parameters[i]);
+                        parameterVariables.push_back(parameter);
+                    }
+                    stack.top(parameters);
 
-                if (nativeInstruction->returnType() != wasm_module::Void::instance()) {
-                    machine().history().addNativeFunctionReturnValue(machine().instructionCounter(),
-                                                                     result.primitiveValue());
-                }
+                    wasm_module::Variable result = nativeInstruction->call(parameterVariables);
+
+                    if (nativeInstruction->returnType() != wasm_module::Void::instance()) {
+                        recordNativeFunctionReturnValue(result.primitiveValue());
+                    }
 
-                currentFrame_->passFunctionResult(result);
+                    currentFrame_->passFunctionResult(result);
+                }
+                traceExit(function);
             }
         } else {
-            pushFrame(FunctionFrame(targetFunction));
+            targetFunction.countCall();
+            pushFrame(targetFunction);
+            traceEnter(function);
 
-            for (int32_t i = parameterSize - 1; i >= 0; i++) {
+            for (int32_t i = parameterSize - 1; i >= 0; i--) {
                 currentFrame().setVariable(i, frames_.at(frames_.size() - 2).pop<uint64_t>());
             }
         }
     }
 
+#ifdef WASMINT_NATIVE_JIT
+    bool VMThread::stepNative(Heap& heap, InstructionCounter& counter) {
+        // the history is replayed in the interpreter, as native code can't stop at a given counter
+        if (!currentFrame_ || !machine().nativeExecution() || machine().reconstructing())
+            return false;
+
+        CompiledFunction& function = currentFrame_->function();
+        // the native code doesn't contain the breakpoints
+        if (stopAtBreakpoints_ && function.hasBreakpoints())
+            return false;
+        if (!function.promoted() && !machine().tieringPolicy().isHot(function.callCount(), function.backEdgeCount()))
+            return false;
+
+        // As native code can be entered at any instruction, a function that gets hot in a loop
+        // continues natively right at the loop header after the back edge that made it hot.
+        const NativeCode* nativeCode = function.nativeCode();
+        if (nativeCode == nullptr || !nativeCode->hasEntry(currentFrame_->instructionPointer()))
+            return false;
+
+        NativeContext context(*this, heap, counter);
+        context.load(*currentFrame_);
+        nativeCode->run(context, currentFrame_->instructionPointer());
+        return true;
+    }
+#endif
+
     void VMThread::finishFrame(uint64_t result) {
         if (frames_.empty())
             throw std::domain_error("Can't call finishFrame(): frame stack is empty!");
@@ -133,6 +251,7 @@ namespace wasmint {
         }
 
         machine().history().threadStackShrinked(*this);
+        traceExit(frames_.back().function().function());
 
         frames_.resize(frames_.size() - 1);
         if (!frames_.empty()) {
@@ -45,8 +45,31 @@ namespace wasmint {
 
         bool finished_ = false;
         static const uint32_t stackLimit = 100000;
+
+        // set by the VMState while it is looking for breakpoints
+        bool stopAtBreakpoints_ = false;
+        bool passBreakpoint_ = false;
+        bool breakpointHit_ = false;
+        bool watchpointHit_ = false;
         wasm_module::Variable result_;
 
+        // statistics for VMStats, which are kept when the thread is reset or restored and
+        // aren't counted again while the history replays instructions
+        uint64_t directCalls_ = 0;
+        uint64_t indirectCalls_ = 0;
+        uint64_t nativeCalls_ = 0;
+        uint64_t heapGrowths_ = 0;
+        std::size_t maxFrameCount_ = 0;
+
+        // called if the frame count may be a new maximum, ignores replayed frames
+        void updateMaxFrameCount();
+
+        // stores the result of a native function in the history and journal
+        void recordNativeFunctionReturnValue(uint64_t value);
+
+        // reports calls to the tracer of the VM if there is one
+        void traceEnter(const wasm_module::Function& function);
+        void traceExit(const wasm_module::Function& function);
 
     public:
         VMThread() {
@@ -79,6 +102,19 @@ namespace wasmint {
         void pushFrame(const FunctionFrame& frame) {
             frames_.push_back(frame);
             currentFrame_ = &frames_.back();
+            if (frames_.size() > maxFrameCount_)
+                updateMaxFrameCount();
+            if (frames_.size() > stackLimit) {
+                trap("call stack exhausted");
+            }
+        }
+
+        // constructs the frame in place to save copying its variables and stack
+        void pushFrame(CompiledFunction& function) {
+            frames_.emplace_back(function);
+            currentFrame_ = &frames_.back();
+            if (frames_.size() > maxFrameCount_)
+                updateMaxFrameCount();
             if (frames_.size() > stackLimit) {
                 trap("call stack exhausted");
             }
@@ -93,6 +129,40 @@ namespace wasmint {
             return finished_;
         }
 
+        std::size_t frameCount() const {
+            return frames_.size();
+        }
+
+        const std::vector<FunctionFrame>& frames() const {
+            return frames_;
+        }
+
+        void countDirectCall();
+
+        void countIndirectCall();
+
+        void countHeapGrowth();
+
+        uint64_t directCalls() const {
+            return directCalls_;
+        }
+
+        uint64_t indirectCalls() const {
+            return indirectCalls_;
+        }
+
+        uint64_t nativeCalls() const {
+            return nativeCalls_;
+        }
+
+        uint64_t heapGrowths() const {
+            return heapGrowths_;
+        }
+
+        std::size_t maxFrameCount() const {
+            return maxFrameCount_;
+        }
+
         bool gotTrap() const {
             return !trapReason_.empty();
         }
@@ -107,12 +177,75 @@ namespace wasmint {
             currentFrame_->step(*this, heap);
         }
 
-        bool stepDebug(Heap& heap) {
-            if (!currentFrame_)
+        /**
+         * Executes instructions in the interpreter until the counter reaches the limit or the
+         * thread finishes. Like VMState::step(), the counter is incremented in front of each
+         * instruction.
+         */
+        void stepUntil(Heap& heap, InstructionCounter& counter, const InstructionCounter& limit) {
+            if (!finished_ && !currentFrame_)
                 throw CantStepEmptyThread("Thread is empty");
-            return currentFrame_->stepDebug(*this, heap);
+            while (!finished_ && counter < limit) {
+                ++counter;
+                currentFrame_->step(*this, heap);
+            }
         }
 
+        /**
+         * If enabled, the thread doesn't execute a breakpoint opcode but stops in front of it.
+         * Otherwise breakpoints are executed like the original opcode.
+         */
+        void stopAtBreakpoints(bool value) {
+            stopAtBreakpoints_ = value;
+        }
+
+        bool stopAtBreakpoints() const {
+            return stopAtBreakpoints_;
+        }
+
+        /**
+         * The next breakpoint is executed like the original opcode even if the thread stops at
+         * breakpoints. Used to continue after the thread stopped at a breakpoint.
+         */
+        void passBreakpoint(bool value) {
+            passBreakpoint_ = value;
+        }
+
+        bool passBreakpoint() const {
+            return passBreakpoint_;
+        }
+
+        /**
+         * True if the last step stopped at a breakpoint instead of executing an instruction.
+         */
+        void breakpointHit(bool value) {
+            breakpointHit_ = value;
+        }
+
+        bool breakpointHit() const {
+            return breakpointHit_;
+        }
+
+        /**
+         * True if the last instruction stored a value in a watched heap range.
+         */
+        void watchpointHit(bool value) {
+            watchpointHit_ = value;
+        }
+
+        bool watchpointHit() const {
+            return watchpointHit_;
+        }
+
+#ifdef WASMINT_NATIVE_JIT
+        /**
+         * Runs the current frame as native code until it calls, returns or traps.
+         * Returns false if there is no native code for the current position. In this
+         * case the caller should fall back to step().
+         */
+        bool stepNative(Heap& heap, InstructionCounter& counter);
+#endif
+
         WasmintVM& machine() {
             return *machine_;
         }
@@ -121,11 +254,29 @@ namespace wasmint {
             return result_;
         }
 
+        /**
+         * Makes this thread empty again so it can be reused for the next call without
+         * giving up the memory it already allocated for its frames.
+         */
+        void reset(WasmintVM* machine);
+
         void enterFunction(std::size_t functionId);
         void enterFunction(std::size_t functionId, const std::vector<wasm_module::Variable>& parameters);
+        void enterFunction(std::size_t functionId, const uint64_t* parameters, std::size_t parameterCount);
 
         void enterFunction(std::size_t functionId, uint32_t parameterSize);
 
+        /**
+         * Hash of the frames and the status of the thread. Threads that are equal have the same hash.
+         */
+        uint64_t hash() const {
+            uint64_t result = frames_.size();
+            for (const FunctionFrame& frame : frames_) {
+                result = StateHash::combine(result, frame.hash());
+            }
+            return StateHash::combine(result, finished_ ? 1 + trapReason_.size() : 0);
+        }
+
         bool operator==(const VMThread& other) const {
 
             if (frames_.size() != other.frames_.size()) {
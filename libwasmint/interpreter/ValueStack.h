@@ -20,45 +20,115 @@
 #include <cstdint>
 #include <vector>
 
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * The operand stack of a function frame.
+ *
+ * The values live in a manually managed buffer so the native backend can push and pop
+ * through a raw pointer and only has to hand the new top back to the stack afterwards.
+ */
 class ValueStack {
 
+    // the elements [0, size_) are on the stack, the rest of the buffer is spare capacity
     std::vector<uint64_t> stack_;
+    std::size_t size_ = 0;
+
+    void grow() {
+        stack_.resize(stack_.empty() ? 16 : stack_.size() * 2);
+    }
 
 public:
+    ValueStack() {
+    }
+
+    ValueStack(const ValueStack& other) : stack_(other.stack_.begin(), other.stack_.begin() + other.size_),
+                                          size_(other.size_) {
+    }
+
+    ValueStack& operator=(const ValueStack& other) {
+        stack_.assign(other.stack_.begin(), other.stack_.begin() + other.size_);
+        size_ = other.size_;
+        return *this;
+    }
+
     template<typename T>
     void push(T value) {
         uint64_t memory = 0;
         *(reinterpret_cast<T*>(&memory)) = value;
-        stack_.push_back(memory);
+        if (size_ == stack_.size())
+            grow();
+        stack_[size_++] = memory;
     }
 
     template<typename T>
     T peek() {
-        uint64_t memory = stack_.back();
+        uint64_t memory = stack_[size_ - 1];
         return *(reinterpret_cast<T*>(&memory));
     }
 
     template<typename T>
     T pop() {
         auto result = peek<T>();
-        stack_.pop_back();
+        size_--;
         return result;
     }
 
     void clear() {
-        stack_.clear();
+        size_ = 0;
     }
 
     bool operator==(const ValueStack& other) const{
-        return stack_ == other.stack_;
+        return size_ == other.size_ && std::equal(stack_.begin(), stack_.begin() + size_, other.stack_.begin());
     }
 
     bool operator!=(const ValueStack& other) const{
-        return stack_ != other.stack_;
+        return !(*this == other);
     }
 
     bool empty() const {
-        return stack_.empty();
+        return size_ == 0;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * The values on the stack, starting with the deepest one.
+     */
+    const uint64_t* values() const {
+        return stack_.data();
+    }
+
+    /**
+     * Pointer to the slot behind the topmost value.
+     */
+    uint64_t* top() {
+        return stack_.data() + size_;
+    }
+
+    /**
+     * Pointer behind the last slot that can be used without growing the stack.
+     */
+    uint64_t* limit() {
+        return stack_.data() + stack_.size();
+    }
+
+    /**
+     * Sets the top of the stack after values were pushed or popped via the pointer returned by top().
+     */
+    void top(uint64_t* newTop) {
+        size_ = (std::size_t) (newTop - stack_.data());
+    }
+
+    /**
+     * Makes sure that at least one more value can be pushed without reallocating.
+     */
+    void reserveSlot() {
+        if (size_ == stack_.size())
+            grow();
     }
 };
 
@@ -19,43 +19,111 @@
 #include "WasmintVM.h"
 
 void wasmint::WasmintVM::loadModule(const std::string &path) {
+    auto start = std::chrono::steady_clock::now();
     wasm_module::Module* module = wasm_module::ModuleLoader::loadFromFile(path);
+    parseTime_ += std::chrono::steady_clock::now() - start;
     loadModule(*module, true);
 }
 
 void wasmint::WasmintVM::loadModuleFromData(const std::string &moduleContent) {
+    auto start = std::chrono::steady_clock::now();
     wasm_module::Module* module = wasm_module::sexpr::ModuleParser::parse(moduleContent);
+    parseTime_ += std::chrono::steady_clock::now() - start;
     loadModule(*module, true);
 }
 
+wasmint::VMStats wasmint::WasmintVM::stats() const {
+    VMStats result;
+    const VMThread& thread = state_.thread();
+    result.instructions = state_.instructionCounter().toUint64();
+    result.directCalls = thread.directCalls();
+    result.indirectCalls = thread.indirectCalls();
+    result.nativeCalls = thread.nativeCalls();
+    result.maxCallDepth = thread.maxFrameCount();
+    result.heapSize = state_.heap().size();
+    result.heapGrowths = thread.heapGrowths();
+    result.historyBytes = history_.memoryUsage();
+    result.parseTime = parseTime_;
+    result.compileTime = compileTime_;
+    result.linkTime = linkTime_;
+#ifdef WASMINT_NATIVE_JIT
+    for (const CompiledFunction& function : functions_) {
+        result.nativeCompileTime += function.nativeCompileTime();
+    }
+#endif
+    return result;
+}
+
 void wasmint::WasmintVM::startAtFunction(const wasm_module::Function& function, bool enableHistory) {
+    FunctionHandle handle = functionHandle(function);
     linkModules();
-    for (std::size_t i = 0; i < functions_.size(); i++) {
-        if (&functions_[i].function() == &function) {
-            state_.heap().removeObserver();
-            state_.heap().attachObserver(history_);
-            state_.startAtFunction(this, i);
-            if (enableHistory) {
-                startHistoryRecording();
-            }
-            return;
-        }
+    observeHeap();
+    state_.startAtFunction(this, handle.index());
+    if (enableHistory) {
+        startHistoryRecording();
     }
-    throw std::domain_error("Can't find compiled function with name " + function.name());
 }
 
 void wasmint::WasmintVM::startAtFunction(const wasm_module::Function& function, const std::vector<wasm_module::Variable>& parameters, bool enableHistory) {
+    startAtFunction(functionHandle(function), parameters, enableHistory);
+}
+
+void wasmint::WasmintVM::startAtFunction(const FunctionHandle& handle, const std::vector<wasm_module::Variable>& parameters, bool enableHistory) {
     linkModules();
+    observeHeap();
+    state_.startAtFunction(this, handle.index(), parameters);
+    if (enableHistory) {
+        startHistoryRecording();
+    }
+}
+
+wasmint::FunctionHandle wasmint::WasmintVM::functionHandle(const wasm_module::Function& function) {
+    std::size_t index;
+    if (findIndex(function.module().name(), function.name(), index) && &functions_[index].function() == &function) {
+        return FunctionHandle(index, function);
+    }
+    // the function is shadowed by another function with the same name
     for (std::size_t i = 0; i < functions_.size(); i++) {
         if (&functions_[i].function() == &function) {
-            state_.heap().removeObserver();
-            state_.heap().attachObserver(history_);
-            state_.startAtFunction(this, i, parameters);
-            if (enableHistory) {
-                startHistoryRecording();
-            }
-            return;
+            return FunctionHandle(i, function);
         }
     }
     throw std::domain_error("Can't find compiled function with name " + function.name());
-}
\ No newline at end of file
+}
+
+void wasmint::WasmintVM::checkCallSignature(const FunctionHandle& handle, const wasm_module::Type* returnType,
+                                            const wasm_module::Type* const* parameterTypes, std::size_t parameterCount) {
+    const wasm_module::Function& function = handle.function();
+    if (function.returnType() != returnType) {
+        throw InvalidCallParameters("Function " + function.name() + " returns " + function.returnType()->name()
+                                    + " but " + returnType->name() + " was expected");
+    }
+    if (function.parameters().size() != parameterCount) {
+        throw InvalidCallParameters("Function " + function.name() + " takes " +
+                                    std::to_string(function.parameters().size())
+                                    + " parameters, but " + std::to_string(parameterCount) + " were given");
+    }
+    for (std::size_t i = 0; i < parameterCount; i++) {
+        if (parameterTypes[i] != function.parameters()[i]) {
+            throw InvalidCallParameters("Type mismatch: Parameter " + std::to_string(i + 1) + " needs type "
+                                        + function.parameters()[i]->name() + " but " + parameterTypes[i]->name()
+                                        + " was given");
+        }
+    }
+}
+
+uint64_t wasmint::WasmintVM::callRaw(const FunctionHandle& handle, const uint64_t* parameters, std::size_t parameterCount) {
+    linkModules();
+    // the call replaces the thread and moves the counter, so the recorded states can't be restored anymore
+    history_.clear();
+    state_.startAtFunction(this, handle.index(), parameters, parameterCount);
+    stepUntilFinished();
+
+    if (state_.gotTrap()) {
+        throw CallTrapped(state_.trapReason());
+    }
+    if (handle.function().returnType() == wasm_module::Void::instance()) {
+        return 0;
+    }
+    return state_.thread().result().primitiveValue();
+}
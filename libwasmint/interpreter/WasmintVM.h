@@ -20,28 +20,107 @@
 
 #include "VMState.h"
 #include "History.h"
+#include "Journal.h"
+#include "OpcodeStatistics.h"
+#include "VMStats.h"
+#include "TieringPolicy.h"
+#include "FunctionHandle.h"
+#include <interpreter/debugging/WatchpointTable.h>
+#include <interpreter/profiling/Tracer.h>
+#include <NativeBinding.h>
+#include <unordered_map>
 
 namespace wasmint {
+
+    ExceptionMessage(CallTrapped)
+
     class WasmintVM {
 
         VMState state_;
         History history_;
+        Journal journal_;
+#ifdef WASMINT_OPCODE_STATS
+        OpcodeStatistics opcodeStatistics_;
+#endif
+        WatchpointTable watchpoints_;
 
         std::vector<CompiledFunction> functions_;
         std::vector<wasm_module::Module*> modules_;
         std::vector<wasm_module::Module*> modulesToDelete_;
 
+        bool nativeExecution_ = true;
+        Tracer* tracer_ = nullptr;
+
+        // time spent in the phases of loadModule() and linkModules() for VMStats
+        std::chrono::nanoseconds parseTime_{0};
+        std::chrono::nanoseconds compileTime_{0};
+        std::chrono::nanoseconds linkTime_{0};
+        TieringPolicy tieringPolicy_;
+
+        // false if functions were compiled since the last call to linkModules()
+        bool linked_ = false;
+
+        void observeHeap() {
+            history_.observe(state_.heap());
+            watchpoints_.stopThread(&state_.thread());
+            watchpoints_.observe(state_.heap());
+        }
+
         void linkModules() {
+            if (linked_)
+                return;
+            auto start = std::chrono::steady_clock::now();
             for (CompiledFunction& function : functions_) {
                 function.jitCompiler().linkGlobally(this);
             }
+            linked_ = true;
+            linkTime_ += std::chrono::steady_clock::now() - start;
+            // attached once here, so call() doesn't have to reattach them on every call
+            observeHeap();
         }
 
-        void compileFunction(const wasm_module::Function* function) {
+        // module name -> function name -> index in functions_
+        std::unordered_map<std::string, std::unordered_map<std::string, std::size_t>> functionIndexes_;
+        // function name -> functions with this name in all loaded modules
+        std::unordered_map<std::string, std::vector<FunctionHandle>> functionsByName_;
+        // export name -> functions exported with this name in all loaded modules
+        std::unordered_map<std::string, std::vector<FunctionHandle>> exportedFunctions_;
+
+        std::size_t compileFunction(const wasm_module::Function* function) {
+            std::size_t index = functions_.size();
             CompiledFunction compiledFunction(function);
             functions_.push_back(compiledFunction);
+            linked_ = false;
+
+            // like a linear search, the lookup finds the first function with a given name
+            functionIndexes_[function->module().name()].insert(std::make_pair(function->name(), index));
+            functionsByName_[function->name()].push_back(FunctionHandle(index, *function));
+            return index;
         }
 
+        const std::vector<FunctionHandle>& findHandles(const std::unordered_map<std::string, std::vector<FunctionHandle>>& handles,
+                                                       const std::string& name) const {
+            static const std::vector<FunctionHandle> noHandles;
+            auto iter = handles.find(name);
+            if (iter == handles.end())
+                return noHandles;
+            return iter->second;
+        }
+
+        template<typename R>
+        static R callResult(uint64_t value, std::false_type) {
+            return wasm_module::NativeBinding::fromRaw<R>(value);
+        }
+
+        template<typename R>
+        static R callResult(uint64_t, std::true_type) {
+        }
+
+        void checkCallSignature(const FunctionHandle& handle, const wasm_module::Type* returnType,
+                                const wasm_module::Type* const* parameterTypes, std::size_t parameterCount);
+
+        uint64_t callRaw(const FunctionHandle& handle, const uint64_t* parameters, std::size_t parameterCount);
+
     public:
         WasmintVM() {
         }
@@ -55,22 +134,58 @@ namespace wasmint {
 
         void startAtFunction(const wasm_module::Function& function, const std::vector<wasm_module::Variable>& parameters, bool enableHistory = true);
 
+        void startAtFunction(const FunctionHandle& handle, const std::vector<wasm_module::Variable>& parameters, bool enableHistory = true);
+
+        FunctionHandle functionHandle(const wasm_module::Function& function);
+
+        FunctionHandle functionHandle(const std::string& module, const std::string& functionName) {
+            std::size_t index = getIndex(module, functionName);
+            return FunctionHandle(index, functions_[index].function());
+        }
+
+        /**
+         * Runs the given function to completion and returns its result. The modules are only
+         * linked on the first call and the arguments are passed to the function without
+         * converting them to Variables first, so repeated calls to the same function are cheap.
+         * The call is not recorded and replaces the thread of the last started execution, so it
+         * clears the history like instantiate(). Throws CallTrapped if the function traps.
+         *
+         * Example: int32_t sum = vm.call<int32_t>(vm.functionHandle("main", "add"), 1, 2);
+         */
+        template<typename R, typename... Args>
+        R call(const FunctionHandle& handle, Args... args) {
+            const wasm_module::Type* parameterTypes[] = {wasm_module::NativeType<Args>::type()..., nullptr};
+            checkCallSignature(handle, wasm_module::NativeType<R>::type(), parameterTypes, sizeof...(Args));
+
+            uint64_t parameters[] = {wasm_module::NativeBinding::toRaw<Args>(args)..., 0};
+            return callResult<R>(callRaw(handle, parameters, sizeof...(Args)), std::is_void<R>());
+        }
+
         void loadModule(const std::string& path);
 
         void loadModuleFromData(const std::string &moduleContent);
 
         void loadModule(wasm_module::Module &module, bool takeMemoryOwnership) {
+            auto start = std::chrono::steady_clock::now();
             if (modules_.empty())
                 state_.useModule(module);
 
             modules_.push_back(&module);
+            std::unordered_map<const wasm_module::Function*, std::size_t> indexes;
             for (auto function :  module.functions()) {
-                compileFunction(function);
+                indexes[function] = compileFunction(function);
+            }
+            for (const auto& exportedFunction : module.exportedFunctions()) {
+                auto iter = indexes.find(exportedFunction.second);
+                if (iter != indexes.end()) {
+                    exportedFunctions_[exportedFunction.first].push_back(FunctionHandle(iter->second, *iter->first));
+                }
             }
 
             if (takeMemoryOwnership) {
                 modulesToDelete_.push_back(&module);
             }
+            compileTime_ += std::chrono::steady_clock::now() - start;
         }
 
         const std::vector<wasm_module::Module*> modules() const {
@@ -81,27 +196,78 @@ namespace wasmint {
             return functions_.at(index);
         }
 
-        std::size_t getIndex(const std::string& module, const std::string& functionName) {
-            for (std::size_t i = 0; i < functions_.size(); i++) {
-                if (functions_[i].function().name() == functionName && functions_[i].function().module().name() == module) {
-                    return i;
-                }
-            }
+        /**
+         * Looks up the index of the given function. Returns false if no such function
+         * was loaded into this VM.
+         */
+        bool findIndex(const std::string& module, const std::string& functionName, std::size_t& index) const {
+            auto moduleIter = functionIndexes_.find(module);
+            if (moduleIter == functionIndexes_.end())
+                return false;
+            auto functionIter = moduleIter->second.find(functionName);
+            if (functionIter == moduleIter->second.end())
+                return false;
+            index = functionIter->second;
+            return true;
+        }
+
+        std::size_t getIndex(const std::string& module, const std::string& functionName) const {
+            std::size_t index;
+            if (findIndex(module, functionName, index))
+                return index;
             throw std::domain_error("Function " + functionName + " in module " + module + " not compiled in this VM");
         }
 
+        /**
+         * All loaded functions with the given name in the order in which their modules were loaded.
+         */
+        const std::vector<FunctionHandle>& functionsWithName(const std::string& functionName) const {
+            return findHandles(functionsByName_, functionName);
+        }
+
+        /**
+         * All functions exported with the given name in the order in which their modules were loaded.
+         */
+        const std::vector<FunctionHandle>& exportedFunctions(const std::string& exportName) const {
+            return findHandles(exportedFunctions_, exportName);
+        }
+
         uint32_t getNumberOfCompiledFunction() const {
             return (uint32_t) functions_.size();
         }
 
         void step() {
             state_.step();
+            if (history_.needsCheckpoint(state_.instructionCounter()) && !state_.thread().finished())
+                history_.addCheckpoint(state_);
             history_.latestStateCounter(state_.instructionCounter());
         }
 
         void stepUntilFinished(bool stopAtBreakpoints = false) {
-            state_.stepUntilFinished(stopAtBreakpoints);
+            stepUntil(std::numeric_limits<uint64_t>::max(), stopAtBreakpoints);
+        }
+
+        /**
+         * Steps until the thread finished, the counter reached the limit or a breakpoint was hit.
+         * Native code can run past the limit. Returns true if the execution stopped at a breakpoint.
+         */
+        bool stepUntil(const InstructionCounter& limit, bool stopAtBreakpoints = false) {
+            bool stopped = false;
+            if (history_.automaticCheckpointsEnabled()) {
+                while (!state_.thread().finished() && state_.instructionCounter() < limit) {
+                    const InstructionCounter& nextCheckpoint = history_.nextCheckpoint();
+                    if (state_.stepUntil(nextCheckpoint < limit ? nextCheckpoint : limit, stopAtBreakpoints)) {
+                        stopped = true;
+                        break;
+                    }
+                    if (history_.needsCheckpoint(state_.instructionCounter()) && !state_.thread().finished())
+                        history_.addCheckpoint(state_);
+                }
+            } else {
+                stopped = state_.stepUntil(limit, stopAtBreakpoints);
+            }
             history_.latestStateCounter(state_.instructionCounter());
+            return stopped;
         }
 
         void stepBack() {
@@ -114,6 +280,14 @@ namespace wasmint {
             history_.setToState(targetCounter, state_);
         }
 
+        /**
+         * Goes back to the last position at which stepUntilFinished(true) would have stopped
+         * before the current one. Returns false if there is none.
+         */
+        bool reverseContinue() {
+            return history_.reverseContinue(state_);
+        }
+
         bool gotTrap() const {
             return state_.gotTrap();
         }
@@ -126,11 +300,49 @@ namespace wasmint {
             return state_.heap();
         }
 
+        /**
+         * Turns this VM into a fresh instance whose heap is a copy-on-write mapping of the
+         * image. The compiled functions are kept, so a module only has to be loaded and
+         * initialized once; afterwards each instance only costs mapping the image.
+         *
+         * Example:
+         *   vm.call<void>(vm.functionHandle("main", "init"));
+         *   HeapImage image(vm.heap());
+         *   // for each request
+         *   vm.instantiate(image);
+         *   vm.call<int32_t>(handler, request);
+         */
+        void instantiate(const HeapImage& image) {
+            history_.clear();
+            state_.heap().useImage(image);
+            state_.instructionCounter(0);
+        }
+
         void startHistoryRecording() {
             history_.clear();
             history_.addCheckpoint(state_);
         }
 
+        /**
+         * Enables or disables running functions as native code in stepUntilFinished().
+         * Only has an effect if wasmint was built with the native JIT.
+         */
+        void nativeExecution(bool enabled) {
+            nativeExecution_ = enabled;
+        }
+
+        bool nativeExecution() const {
+            return nativeExecution_;
+        }
+
+        void tieringPolicy(const TieringPolicy& policy) {
+            tieringPolicy_ = policy;
+        }
+
+        const TieringPolicy& tieringPolicy() const {
+            return tieringPolicy_;
+        }
+
         bool reconstructing() const {
             return history_.reconstructing();
         }
@@ -139,6 +351,39 @@ namespace wasmint {
             return history_;
         }
 
+        /**
+         * Records the return values of the native functions into a file or replays them from one.
+         */
+        Journal& journal() {
+            return journal_;
+        }
+
+        const Journal& journal() const {
+            return journal_;
+        }
+
+        /**
+         * What the VM did so far, see VMStats.
+         */
+        VMStats stats() const;
+
+        /**
+         * Records the function calls of the thread in the given tracer, or stops tracing if it is nullptr.
+         */
+        void tracer(Tracer* tracer) {
+            tracer_ = tracer;
+        }
+
+        Tracer* tracer() const {
+            return tracer_;
+        }
+
+#ifdef WASMINT_OPCODE_STATS
+        OpcodeStatistics& opcodeStatistics() {
+            return opcodeStatistics_;
+        }
+#endif
+
         const InstructionCounter& instructionCounter() const {
             return state_.instructionCounter();
         }
@@ -154,9 +399,29 @@ namespace wasmint {
             return state().thread().finished();
         }
 
+        /**
+         * Stops stepUntilFinished(true) after every instruction that stores a value in
+         * [start, start + size) and calls the handler before the value is stored.
+         */
+        void addWatchpoint(std::size_t start, std::size_t size, WatchpointHandler* handler = nullptr) {
+            watchpoints_.add(Watchpoint(Interval::withEnd(start, start + size), handler));
+            observeHeap();
+        }
+
+        bool removeWatchpoint(std::size_t start, std::size_t size) {
+            bool removed = watchpoints_.remove(Interval::withEnd(start, start + size));
+            observeHeap();
+            return removed;
+        }
+
+        const WatchpointTable& watchpoints() const {
+            return watchpoints_;
+        }
+
         void addBreakpoint(const wasm_module::Instruction* instruction, BreakpointHandler* handler = nullptr) {
             for (CompiledFunction& function : functions_) {
-                function.addBreakpoint(instruction, handler);
+                if (function.jitCompiler().hasCompiled(instruction))
+                    function.addBreakpoint(instruction, handler);
             }
         }
 
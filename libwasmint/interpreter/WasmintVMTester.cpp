@@ -23,12 +23,12 @@ void wasmint::WasmintVMTester::stepUntilFinished() {
     vm_.startHistoryRecording();
 
 
-    VMState startState = vm_.state();
+    VMSnapshot startState(vm_.state());
     while (true) {
         vm_.step();
         if (selectedIntermediateStates.size() < maxIntermediateStates
             && vm_.instructionCounter().multipleOf(intermediateStateInterval)) {
-            selectedIntermediateStates[vm_.instructionCounter()] = vm_.state();
+            selectedIntermediateStates[vm_.instructionCounter()].reset(new VMSnapshot(vm_.state()));
         }
         if (vm_.instructionCounter().multipleOf(5) && !vm_.finished()) {
             vm_.history().addCheckpoint(vm_.state());
@@ -37,11 +37,11 @@ void wasmint::WasmintVMTester::stepUntilFinished() {
             break;
         }
     }
-    VMState endState = vm_.state();
+    VMSnapshot endState(vm_.state());
 
     for (auto& pair : selectedIntermediateStates) {
         vm_.simulateTo(pair.first);
-        if (pair.second != vm_.state()) {
+        if (*pair.second != vm_.state()) {
             throw FailedVMTest("Couldn't simulate to selected state");
         }
     }
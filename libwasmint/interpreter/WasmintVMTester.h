@@ -19,6 +19,8 @@
 #define WASMINT_WASMINTVMTESTER_H
 
 #include "WasmintVM.h"
+#include "VMSnapshot.h"
+#include <memory>
 
 namespace wasmint {
 
@@ -31,7 +33,7 @@ namespace wasmint {
 
         std::size_t maxIntermediateStates = 10;
         std::size_t intermediateStateInterval = 50;
-        std::map<InstructionCounter, VMState> selectedIntermediateStates;
+        std::map<InstructionCounter, std::unique_ptr<VMSnapshot>> selectedIntermediateStates;
 
     public:
         WasmintVMTester(WasmintVM& vm) : vm_(vm) {
@@ -847,6 +847,9 @@ namespace wasmint {
                         case 1:
                             return instruction.children().at(1);
                         default:
+                            // the first child is the condition
+                            if (state.results().front().int32() == 0)
+                                return StepResult();
                             return StepResult::createBranch(state.results().back(), dynamic_cast<const BranchIf&>(instruction).branchLabel());
                     }
 
@@ -22,11 +22,17 @@
 
 namespace wasmint {
     std::string BreakpointEnvironment::returnValue() {
-        if (breakpoint_->instruction()->returnType() == wasm_module::Void::instance()) {
+        const wasm_module::Type* type = breakpoint_->instruction()->returnType();
+        if (type == wasm_module::Void::instance()) {
             return "";
-        } else {
-            // FIXME: dummy code
-            return "dummy";
         }
+        // the thread stops directly after the instruction, so its result is on top of the stack
+        ValueStack& stack = state_->thread().currentFrame().stack();
+        if (stack.empty()) {
+            return "";
+        }
+        wasm_module::Variable result(type);
+        result.setFromPrimitiveValue(stack.peek<uint64_t>());
+        return result.toString();
     }
 }
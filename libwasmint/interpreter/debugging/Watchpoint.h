@@ -0,0 +1,55 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_WATCHPOINT_H
+#define WASMINT_WATCHPOINT_H
+
+#include <interpreter/heap/Interval.h>
+
+namespace wasmint {
+
+    class WatchpointHandler;
+
+    /**
+     * Stops the execution after an instruction that stored a value in the given heap range.
+     */
+    class Watchpoint {
+
+        Interval interval_;
+        WatchpointHandler* handler_ = nullptr;
+
+    public:
+        Watchpoint() {
+        }
+
+        Watchpoint(const Interval& interval, WatchpointHandler* handler = nullptr)
+                : interval_(interval), handler_(handler) {
+        }
+
+        const Interval& interval() const {
+            return interval_;
+        }
+
+        WatchpointHandler* handler() const {
+            return handler_;
+        }
+    };
+
+}
+
+#endif //WASMINT_WATCHPOINT_H
@@ -15,35 +15,24 @@
  */
 
 
-#ifndef WASMINT_HEAPPATCHCHUNK_H
-#define WASMINT_HEAPPATCHCHUNK_H
 
-#include <cstdint>
-#include <vector>
+#ifndef WASMINT_WATCHPOINTHANDLER_H
+#define WASMINT_WATCHPOINTHANDLER_H
+
 #include <interpreter/heap/Interval.h>
 
 namespace wasmint {
-    class HeapPatchChunk : public Interval {
-        std::vector<uint8_t> data_;
+    class Heap;
+    class Watchpoint;
 
+    class WatchpointHandler {
     public:
-        HeapPatchChunk() {
-        }
-        HeapPatchChunk(Interval interval) : Interval(interval) {
-            data_.resize(interval.size());
-        }
-
-        void setByte(std::size_t pos, uint8_t value) {
-            data_[pos - start()] = value;
-        }
-
-        const std::vector<uint8_t> data() const {
-            return data_;
-        }
-
+        /**
+         * Called before the value is stored, so the heap still contains the old content
+         * of the changed interval.
+         */
+        virtual void reachedWatchpoint(const Watchpoint& watchpoint, const Heap& heap, const Interval& changedInterval) = 0;
     };
 }
 
-
-
-#endif //WASMINT_HEAPPATCHCHUNK_H
+#endif //WASMINT_WATCHPOINTHANDLER_H
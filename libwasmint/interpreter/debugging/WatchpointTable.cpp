@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "WatchpointTable.h"
+#include "WatchpointHandler.h"
+#include <interpreter/WasmintVM.h>
+#include <algorithm>
+
+namespace wasmint {
+
+    const std::size_t WatchpointTable::lineSize;
+
+    void WatchpointTable::countLines(const Interval& interval, int32_t delta) {
+        if (interval.size() == 0)
+            return;
+        std::size_t firstLine = interval.start() / lineSize;
+        std::size_t lastLine = (interval.end() - 1) / lineSize;
+        if (lastLine >= watchpointsPerLine_.size())
+            watchpointsPerLine_.resize(lastLine + 1, 0);
+        for (std::size_t line = firstLine; line <= lastLine; line++) {
+            watchpointsPerLine_[line] += delta;
+        }
+        // stores behind the last watched line are rejected by the size check
+        while (!watchpointsPerLine_.empty() && watchpointsPerLine_.back() == 0) {
+            watchpointsPerLine_.pop_back();
+        }
+    }
+
+    void WatchpointTable::trigger(const Heap& heap, const Interval& changedInterval) {
+        // replaying the history executes the stores a second time, but it can look for the previous hit
+        bool replaying = thread_ && thread_->machine().reconstructing();
+
+        bool hit = false;
+        for (const Watchpoint& watchpoint : watchpoints_) {
+            if (watchpoint.interval().overlaps(changedInterval)) {
+                hit = true;
+                if (watchpoint.handler() && !replaying)
+                    watchpoint.handler()->reachedWatchpoint(watchpoint, heap, changedInterval);
+            }
+        }
+        if (hit && thread_ && thread_->stopAtBreakpoints())
+            thread_->watchpointHit(true);
+    }
+
+    void WatchpointTable::add(const Watchpoint& watchpoint) {
+        watchpoints_.push_back(watchpoint);
+        countLines(watchpoint.interval(), 1);
+    }
+
+    bool WatchpointTable::remove(const Interval& interval) {
+        bool removed = false;
+        for (auto iter = watchpoints_.begin(); iter != watchpoints_.end(); ) {
+            if (iter->interval().start() == interval.start() && iter->interval().end() == interval.end()) {
+                countLines(interval, -1);
+                iter = watchpoints_.erase(iter);
+                removed = true;
+            } else {
+                ++iter;
+            }
+        }
+        return removed;
+    }
+
+    void WatchpointTable::clear() {
+        watchpoints_.clear();
+        watchpointsPerLine_.clear();
+    }
+
+    void WatchpointTable::observe(Heap& heap) {
+        heap.removeObserver(*this);
+        if (!watchpoints_.empty())
+            heap.attachObserver(*this);
+    }
+}
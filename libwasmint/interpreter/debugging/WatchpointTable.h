@@ -0,0 +1,102 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_WATCHPOINTTABLE_H
+#define WASMINT_WATCHPOINTTABLE_H
+
+#include <cstdint>
+#include <vector>
+#include <interpreter/heap/HeapObserver.h>
+#include "Watchpoint.h"
+
+namespace wasmint {
+
+    class VMThread;
+
+    /**
+     * The watchpoints of a VM. The heap is divided into lines of lineSize bytes and the table
+     * counts how many watchpoints overlap each line, so a store that hits no watchpoint only
+     * costs a single lookup. Only stores to a watched line compare the single watchpoints.
+     */
+    class WatchpointTable : public HeapObserver {
+
+        std::vector<Watchpoint> watchpoints_;
+        // number of watchpoints that overlap each line, ends with the last watched line
+        std::vector<uint32_t> watchpointsPerLine_;
+
+        // stopped after an instruction that triggered a watchpoint
+        VMThread* thread_ = nullptr;
+
+        void countLines(const Interval& interval, int32_t delta);
+
+        void trigger(const Heap& heap, const Interval& changedInterval);
+
+    public:
+        static const std::size_t lineSize = 64;
+
+        WatchpointTable() {
+        }
+
+        void add(const Watchpoint& watchpoint);
+
+        /**
+         * Removes all watchpoints with exactly the given interval. Returns false if there was none.
+         */
+        bool remove(const Interval& interval);
+
+        void clear();
+
+        bool empty() const {
+            return watchpoints_.empty();
+        }
+
+        const std::vector<Watchpoint>& watchpoints() const {
+            return watchpoints_;
+        }
+
+        /**
+         * Observes the given heap as long as there are watchpoints.
+         */
+        void observe(Heap& heap);
+
+        /**
+         * The thread that is stopped after an instruction hit a watchpoint if it
+         * currently stops at breakpoints.
+         */
+        void stopThread(VMThread* thread) {
+            thread_ = thread;
+        }
+
+        bool watched(const Interval& interval) const {
+            std::size_t line = interval.start() / lineSize;
+            std::size_t lastLine = (interval.end() - 1) / lineSize;
+            for (; line <= lastLine && line < watchpointsPerLine_.size(); line++) {
+                if (watchpointsPerLine_[line] != 0)
+                    return true;
+            }
+            return false;
+        }
+
+        virtual void preChanged(const Heap& heap, const Interval& changedInterval) override {
+            if (watched(changedInterval))
+                trigger(heap, changedInterval);
+        }
+    };
+}
+
+#endif //WASMINT_WATCHPOINTTABLE_H
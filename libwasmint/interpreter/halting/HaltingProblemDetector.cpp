@@ -18,14 +18,169 @@
 #include "HaltingProblemDetector.h"
 #include <stdexcept>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+
+void wasmint::HaltingProblemDetector::step() {
+    vm_.step();
+    if (vm_.instructionCounter().multipleOf(hashInterval_)) {
+        // the heap hash is maintained from now on, so hashing a state doesn't depend on the heap size
+        if (!vm_.heap().hashing())
+            vm_.heap().hashing(true);
+        stateHashes_[vm_.state().stateHash()].push_back(vm_.instructionCounter());
+        if (++sampledStates_ > maxSampledStates_)
+            thinSampledStates();
+    }
+}
+
+void wasmint::HaltingProblemDetector::thinSampledStates() {
+    hashInterval_ *= 2;
+    sampledStates_ = 0;
+    for (auto iter = stateHashes_.begin(); iter != stateHashes_.end(); ) {
+        std::vector<InstructionCounter>& counters = iter->second;
+        counters.erase(std::remove_if(counters.begin(), counters.end(), [&](const InstructionCounter& counter) {
+            return counter.toUint64() % hashInterval_ != 0;
+        }), counters.end());
+        sampledStates_ += counters.size();
+        if (counters.empty())
+            iter = stateHashes_.erase(iter);
+        else
+            ++iter;
+    }
+}
 
 bool wasmint::HaltingProblemDetector::isLooping(InstructionCounter startCounter) {
     if (startCounter > vm_.instructionCounter()) {
         throw std::domain_error("startCounter is bigger than the current vm instruction counter");
     }
 
+    if (!stateHashes_.empty())
+        return isLoopingByHash(startCounter);
+    if (workerThreads_ > 1)
+        return isLoopingInParallel(startCounter);
+    return isLoopingSequentially(startCounter);
+}
+
+namespace {
+    // the states in [start, end) that are replayed from the checkpoint before start
+    struct HistoryRange {
+        wasmint::InstructionCounter start;
+        wasmint::InstructionCounter end;
+    };
+}
+
+bool wasmint::HaltingProblemDetector::isLoopingInParallel(InstructionCounter startCounter) {
+    const VMState& currentState = vm_.state();
+    const InstructionCounter currentCounter = currentState.instructionCounter();
+    totalStates_ = currentCounter.toUint64();
+
+    // Sorted from the newest to the oldest state like the sequential search visits them. The search
+    // stops at the newest patch that depends on the external state, as the states before it don't
+    // have to lead to the current state again.
+    std::vector<HistoryRange> ranges;
+    bool reachedExternalState = false;
+    InstructionCounter end = currentCounter;
+    while (startCounter < end) {
+        InstructionCounter last = end;
+        --last;
+        const MachinePatch& patch = vm_.history().getCheckpoint(last);
+        if (patch.influencedByExternalState()) {
+            reachedExternalState = true;
+            break;
+        }
+        HistoryRange range;
+        range.start = std::max(patch.startCounter(), startCounter);
+        range.end = end;
+        // the replay looks up the return values by the counter of the VM and not by the one of the copy
+        if (vm_.history().hasNativeFunctionReturnValues(range.start, range.end))
+            return isLoopingSequentially(startCounter);
+        ranges.push_back(range);
+        end = range.start;
+    }
+
+    const uint64_t currentHash = currentState.stateHash();
+    const HeapImage image(currentState.heap());
+
+    // the index of the newest range with a repeated state, older ranges don't need to be searched anymore
+    std::atomic<std::size_t> matchingRange(ranges.size());
+    std::atomic<std::size_t> nextRange(0);
+    std::atomic<uint64_t> replayedStates(0);
+    std::atomic<bool> failed(false);
+
+    std::size_t threadCount = std::min<std::size_t>(workerThreads_, ranges.size());
+    std::vector<std::exception_ptr> errors(threadCount);
+
+    auto search = [&](std::size_t threadIndex) {
+        try {
+            VMState state;
+            state.heap().useImage(image);
+            state.heap().hashing(true);
+            state.thread() = currentState.thread();
+            state.instructionCounter(currentCounter);
+
+            uint64_t replayed = 0;
+            while (!failed) {
+                std::size_t rangeIndex = nextRange++;
+                if (rangeIndex >= matchingRange)
+                    break;
+                const HistoryRange& range = ranges[rangeIndex];
+
+                vm_.history().rollback(range.start, state);
+                while (state.instructionCounter() < range.end) {
+                    if (rangeIndex > matchingRange.load(std::memory_order_relaxed) || failed)
+                        break;
+                    if (state.instructionCounter() >= range.start && state.stateHash() == currentHash
+                        && state.thread() == currentState.thread() && state.heap() == currentState.heap()) {
+                        std::size_t newest = matchingRange;
+                        while (rangeIndex < newest && !matchingRange.compare_exchange_weak(newest, rangeIndex)) {
+                        }
+                        break;
+                    }
+                    state.step();
+                    replayed++;
+                }
+            }
+            replayedStates += replayed;
+        } catch (...) {
+            errors[threadIndex] = std::current_exception();
+            failed = true;
+        }
+    };
+
+    // the threads replay the states, so nothing they execute may be recorded
+    vm_.history().reconstructing(true);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(search, i);
+    }
+    if (threadCount > 0)
+        search(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    vm_.history().reconstructing(false);
+
+    for (const std::exception_ptr& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    ignoredStates_ = totalStates_ - std::min<uint64_t>(totalStates_, replayedStates);
+
+    if (matchingRange < ranges.size())
+        return true;
+    if (reachedExternalState)
+        throw CantMakeHaltingDecision("Patch indicates that its related state depend on the external state");
+    return false;
+}
+
+bool wasmint::HaltingProblemDetector::isLoopingSequentially(InstructionCounter startCounter) {
     bool result = false;
-    const VMState backupState = vm_.state();
+    // only the chunks that are modified while rolling back are copied
+    const VMSnapshot backupState(vm_.state());
+    // comparing hashes first is only cheaper than comparing the states if the heap hash is maintained
+    const bool compareHashes = vm_.heap().hashing();
+    const uint64_t backupHash = compareHashes ? vm_.state().stateHash() : 0;
 
     totalStates_ = vm_.instructionCounter().toUint64();
 
@@ -55,7 +210,7 @@ bool wasmint::HaltingProblemDetector::isLooping(InstructionCounter startCounter)
             }
         }
 
-        const std::set<std::size_t>& modifiedPages = lastPatch.heapPatch().modifiedChunks();
+        const std::vector<std::size_t> modifiedPages = lastPatch.heapPatch().modifiedChunks();
 
         bool modifiesRelevantPages = std::includes(modifiedPages.begin(), modifiedPages.end(),
                                                 pagesThatNeedChecks.begin(), pagesThatNeedChecks.end());
@@ -65,7 +220,8 @@ bool wasmint::HaltingProblemDetector::isLooping(InstructionCounter startCounter)
         if (modifiesRelevantPages) {
             InstructionCounter counter = nextRollbackCounter;
             while (counter != lastCounter) {
-                if (isIdentical(vm_.state(), backupState, pagesThatNeedChecks)) {
+                if ((!compareHashes || vm_.state().stateHash() == backupHash)
+                    && isIdentical(vm_.state(), backupState, pagesThatNeedChecks)) {
                     ignoredStates_ += counter.toUint64();
                     result = true;
                     break;
@@ -88,13 +244,73 @@ bool wasmint::HaltingProblemDetector::isLooping(InstructionCounter startCounter)
         }
     }
 
-    vm_.state() = backupState;
-    assert(vm_.state() == backupState);
+    backupState.restore(vm_.state());
+    assert(backupState == vm_.state());
 
     return result;
 }
 
-bool wasmint::HaltingProblemDetector::isIdentical(const VMState& a, const VMState& b, std::set<std::size_t>& indexes) {
+bool wasmint::HaltingProblemDetector::isLoopingByHash(InstructionCounter startCounter) {
+    const InstructionCounter currentCounter = vm_.instructionCounter();
+    totalStates_ = currentCounter.toUint64();
+
+    // if the program loops with a period that fits the sampling, a sampled state with the same hash is identical
+    auto candidates = stateHashes_.find(vm_.state().stateHash());
+    if (candidates != stateHashes_.end()) {
+        const VMSnapshot backupState(vm_.state());
+        bool result = false;
+        // the patches in [checkedCounter, currentCounter) don't depend on the external state
+        InstructionCounter checkedCounter = currentCounter;
+        InstructionCounter patchCounter = currentCounter;
+
+        // like the full search, the newest repeated state is searched first
+        for (auto candidate = candidates->second.rbegin(); candidate != candidates->second.rend(); ++candidate) {
+            const InstructionCounter& candidateCounter = *candidate;
+            if (candidateCounter >= currentCounter)
+                continue;
+            if (candidateCounter < startCounter)
+                break;
+
+            // the states are only guaranteed to repeat if nothing in between depends on the external state
+            while (candidateCounter < checkedCounter) {
+                const MachinePatch& patch = vm_.history().getCheckpoint(patchCounter);
+                if (patch.influencedByExternalState()) {
+                    backupState.restore(vm_.state());
+                    throw CantMakeHaltingDecision("Patch indicates that its related state depend on the external state");
+                }
+                checkedCounter = patch.startCounter();
+                patchCounter = checkedCounter;
+                --patchCounter;
+            }
+
+            // the hashes can collide, so the states are compared before we make a decision
+            vm_.simulateTo(candidateCounter);
+            if (isIdentical(vm_.state(), backupState)) {
+                result = true;
+                break;
+            }
+        }
+
+        backupState.restore(vm_.state());
+        assert(backupState == vm_.state());
+        if (result) {
+            ignoredStates_ = totalStates_ - 1;
+            return true;
+        }
+    }
+
+    // the repetition can start before the first sample or have a period that the samples miss
+    if (workerThreads_ > 1)
+        return isLoopingInParallel(startCounter);
+    return isLoopingSequentially(startCounter);
+}
+
+bool wasmint::HaltingProblemDetector::isIdentical(const VMState& a, const VMSnapshot& b) {
+    // the instruction counter differs on purpose
+    return a.thread() == b.thread() && b.heap() == a.heap();
+}
+
+bool wasmint::HaltingProblemDetector::isIdentical(const VMState& a, const VMSnapshot& b, std::set<std::size_t>& indexes) {
     // we don't compare the instruction pointer which is on purpose
     // as we only compare for memory/thread equality when checking for reoccurring states
 
@@ -110,6 +326,7 @@ bool wasmint::HaltingProblemDetector::isIdentical(const VMState& a, const VMStat
     return true;
 }
 
-bool wasmint::HaltingProblemDetector::comparePage(const Heap& a, const Heap& b, std::size_t pageIndex) {
-    return a.equalRange(b, HeapPatch::chunkSize * pageIndex, HeapPatch::chunkSize * (pageIndex + 1));
+bool wasmint::HaltingProblemDetector::comparePage(const Heap& a, const HeapSnapshot& b, std::size_t pageIndex) {
+    std::size_t chunkSize = vm_.history().heapPatchChunkSize();
+    return b.equalRange(a, chunkSize * pageIndex, chunkSize * (pageIndex + 1));
 }
\ No newline at end of file
@@ -19,7 +19,13 @@
 #define WASMINT_HALTINGPROBLEMDETECTOR_H
 
 #include <interpreter/WasmintVM.h>
+#include <interpreter/VMSnapshot.h>
 #include <iomanip>
+#include <set>
+#include <unordered_map>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 namespace wasmint {
 
@@ -32,11 +38,80 @@ namespace wasmint {
 
         WasmintVM& vm_;
 
-        bool comparePage(const Heap& a, const Heap& b, std::size_t pageIndex);
-        bool isIdentical(const VMState& a, const VMState& b, std::set<std::size_t>& indexes);
+        unsigned workerThreads_;
+
+        uint64_t hashInterval_ = 64;
+        // the hash of every sampled state mapped to all counters at which it was seen, oldest first
+        std::unordered_map<uint64_t, std::vector<InstructionCounter>> stateHashes_;
+        std::size_t sampledStates_ = 0;
+        std::size_t maxSampledStates_ = 1024 * 1024;
+
+        // drops every second sample and doubles the hash interval, like History thins its checkpoints
+        void thinSampledStates();
+
+        bool comparePage(const Heap& a, const HeapSnapshot& b, std::size_t pageIndex);
+        bool isIdentical(const VMState& a, const VMSnapshot& b, std::set<std::size_t>& indexes);
+        bool isIdentical(const VMState& a, const VMSnapshot& b);
+
+        bool isLoopingByHash(InstructionCounter startCounter);
+        bool isLoopingInParallel(InstructionCounter startCounter);
+        bool isLoopingSequentially(InstructionCounter startCounter);
 
     public:
-        HaltingProblemDetector(WasmintVM& vm) : vm_(vm) {
+        HaltingProblemDetector(WasmintVM& vm)
+                : vm_(vm), workerThreads_(std::max(1u, std::thread::hardware_concurrency())) {
+        }
+
+        /**
+         * Executes the next instruction and remembers the hash of every hashInterval-th state.
+         * If the VM is only stepped via this method, isLooping() first compares the current state
+         * with the sampled states that have the same hash. Only if none of them is identical, the
+         * whole history is searched.
+         */
+        void step();
+
+        void hashInterval(uint64_t interval) {
+            if (interval == 0)
+                throw std::domain_error("The hash interval can't be 0");
+            hashInterval_ = interval;
+        }
+
+        /**
+         * The current interval, which doubles each time more than maxSampledStates states were sampled.
+         */
+        uint64_t hashInterval() const {
+            return hashInterval_;
+        }
+
+        /**
+         * Limits the memory used for the sampled states. Older samples are thinned out, so the
+         * samples still cover the whole execution.
+         */
+        void maxSampledStates(std::size_t states) {
+            if (states == 0)
+                throw std::domain_error("At least one state has to be sampled");
+            maxSampledStates_ = states;
+        }
+
+        std::size_t maxSampledStates() const {
+            return maxSampledStates_;
+        }
+
+        std::size_t sampledStates() const {
+            return sampledStates_;
+        }
+
+        /**
+         * The number of threads that search the history if no state hashes were recorded via
+         * step(). Each thread replays its own copy-on-write copy of the heap, and all threads stop
+         * as soon as the repeated state in the newest part of the history is found.
+         */
+        void workerThreads(unsigned threads) {
+            workerThreads_ = std::max(1u, threads);
+        }
+
+        unsigned workerThreads() const {
+            return workerThreads_;
         }
 
         bool isLooping(InstructionCounter startCounter = 0);
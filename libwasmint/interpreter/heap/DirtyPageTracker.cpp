@@ -0,0 +1,251 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "DirtyPageTracker.h"
+#include "Heap.h"
+#include "patch/HeapPatch.h"
+
+#ifdef WASMINT_DIRTY_PAGE_TRACKING
+#include <sys/mman.h>
+#include <signal.h>
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace wasmint {
+
+#ifdef WASMINT_DIRTY_PAGE_TRACKING
+
+    namespace {
+        const std::size_t maximumTrackers = 64;
+        std::atomic<DirtyPageTracker*> trackers[maximumTrackers];
+        std::mutex trackersMutex;
+        bool handlersInstalled = false;
+
+        // write faults are reported as SIGSEGV on Linux and as SIGBUS on some BSDs
+        const int faultSignals[] = {SIGSEGV, SIGBUS};
+        struct sigaction previousActions[2];
+
+        void handleFault(int signal, siginfo_t* info, void* context) {
+            for (std::size_t i = 0; i < maximumTrackers; i++) {
+                DirtyPageTracker* tracker = trackers[i].load(std::memory_order_acquire);
+                if (tracker && tracker->handleWriteFault(info->si_addr))
+                    return;
+            }
+
+            // the fault wasn't caused by a tracker, so we forward it to the previous handler
+            struct sigaction& previous = previousActions[signal == SIGSEGV ? 0 : 1];
+            if (previous.sa_flags & SA_SIGINFO) {
+                previous.sa_sigaction(signal, info, context);
+            } else if (previous.sa_handler == SIG_DFL || previous.sa_handler == SIG_IGN) {
+                // the faulting instruction is executed again and fails as if we never handled it
+                sigaction(signal, &previous, nullptr);
+            } else {
+                previous.sa_handler(signal);
+            }
+        }
+
+        void registerTracker(DirtyPageTracker* tracker) {
+            std::lock_guard<std::mutex> lock(trackersMutex);
+            if (!handlersInstalled) {
+                struct sigaction action;
+                action.sa_sigaction = handleFault;
+                sigemptyset(&action.sa_mask);
+                action.sa_flags = SA_SIGINFO | SA_RESTART;
+                for (std::size_t i = 0; i < 2; i++) {
+                    if (sigaction(faultSignals[i], &action, &previousActions[i]) != 0)
+                        throw DirtyPageTrackingNotSupported("Can't install the handler for write faults");
+                }
+                handlersInstalled = true;
+            }
+            for (std::size_t i = 0; i < maximumTrackers; i++) {
+                if (trackers[i].load() == tracker)
+                    return;
+            }
+            for (std::size_t i = 0; i < maximumTrackers; i++) {
+                if (trackers[i].load() == nullptr) {
+                    trackers[i].store(tracker, std::memory_order_release);
+                    return;
+                }
+            }
+            throw DirtyPageTrackingNotSupported("Only " + std::to_string(maximumTrackers)
+                                                + " heaps can be tracked at the same time");
+        }
+
+        void unregisterTracker(DirtyPageTracker* tracker) {
+            std::lock_guard<std::mutex> lock(trackersMutex);
+            for (std::size_t i = 0; i < maximumTrackers; i++) {
+                if (trackers[i].load() == tracker)
+                    trackers[i].store(nullptr, std::memory_order_release);
+            }
+        }
+    }
+
+    DirtyPageTracker::~DirtyPageTracker() {
+        disarm();
+        if (pool_)
+            munmap(pool_, poolPages_ * pageSize_);
+    }
+
+    bool DirtyPageTracker::supported() {
+        return true;
+    }
+
+    void DirtyPageTracker::reservePool(std::size_t pages) {
+        if (pages <= poolPages_)
+            return;
+        if (pool_)
+            munmap(pool_, poolPages_ * pageSize_);
+        pool_ = nullptr;
+        poolPages_ = 0;
+
+        // the pool only reserves address space, the kernel provides memory for the touched pages
+        void* memory = mmap(nullptr, pages * pageSize_, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw CantProtectHeapPages("Can't reserve " + std::to_string(pages) + " pages for the dirty page pool");
+        }
+        pool_ = (uint8_t*) memory;
+        poolPages_ = pages;
+    }
+
+    void DirtyPageTracker::arm(Heap& heap) {
+        if (heap_ != &heap) {
+            disarm();
+            heap.attachPageTracker(*this);
+            heap_ = &heap;
+        } else {
+            release();
+        }
+        pageSize_ = systemPageSize();
+        trackedPages_ = (heap.size() + pageSize_ - 1) / pageSize_;
+        reservePool(trackedPages_);
+
+        dirtyBitmap_.assign((trackedPages_ + 63) / 64, 0);
+        dirtyPages_.resize(trackedPages_);
+        dirtyPageCount_ = 0;
+
+        registerTracker(this);
+        protect();
+    }
+
+    void DirtyPageTracker::disarm() {
+        release();
+        if (heap_) {
+            heap_->removePageTracker();
+            heap_ = nullptr;
+            unregisterTracker(this);
+        }
+        dirtyPageCount_ = 0;
+    }
+
+    void DirtyPageTracker::release() {
+        if (protectedPages_ != 0) {
+            if (mprotect(protectedStart_, protectedPages_ * pageSize_, PROT_READ | PROT_WRITE) != 0)
+                throw CantProtectHeapPages("Can't make the heap writable again");
+        }
+        protectedStart_ = nullptr;
+        protectedPages_ = 0;
+    }
+
+    void DirtyPageTracker::protect() {
+        if (heap_ == nullptr)
+            return;
+        release();
+
+        uint8_t* start = const_cast<uint8_t*>(heap_->data());
+        // pages that were added after arming are not part of the patch and aren't tracked
+        std::size_t pages = std::min(trackedPages_, (heap_->size() + pageSize_ - 1) / pageSize_);
+        if (pages == 0)
+            return;
+
+        protectedStart_ = start;
+        protectedPages_ = pages;
+
+        std::size_t runStart = 0;
+        for (std::size_t page = 0; page <= pages; page++) {
+            if (page == pages || isDirty(page)) {
+                if (page > runStart) {
+                    if (mprotect(start + runStart * pageSize_, (page - runStart) * pageSize_, PROT_READ) != 0)
+                        throw CantProtectHeapPages("Can't write-protect the heap");
+                }
+                runStart = page + 1;
+            }
+        }
+    }
+
+    void DirtyPageTracker::flush(HeapPatch& patch) const {
+        if (dirtyPageCount_ == 0)
+            return;
+        if (patch.chunkSize() != pageSize_)
+            throw InvalidChunkSize("The chunk size of the patch has to be the page size of the system");
+        for (std::size_t i = 0; i < dirtyPageCount_; i++) {
+            std::size_t page = dirtyPages_[i];
+            patch.backupChunk(page, pool_ + page * pageSize_);
+        }
+    }
+
+    bool DirtyPageTracker::handleWriteFault(const void* address) {
+        const uint8_t* faultAddress = static_cast<const uint8_t*>(address);
+        if (protectedPages_ == 0 || faultAddress < protectedStart_
+            || faultAddress >= protectedStart_ + protectedPages_ * pageSize_)
+            return false;
+
+        std::size_t page = (faultAddress - protectedStart_) / pageSize_;
+        uint8_t* pageStart = protectedStart_ + page * pageSize_;
+        if (!isDirty(page)) {
+            std::memcpy(pool_ + page * pageSize_, pageStart, pageSize_);
+            dirtyBitmap_[page / 64] |= uint64_t(1) << (page % 64);
+            dirtyPages_[dirtyPageCount_++] = page;
+        }
+        return mprotect(pageStart, pageSize_, PROT_READ | PROT_WRITE) == 0;
+    }
+
+#else
+
+    DirtyPageTracker::~DirtyPageTracker() {
+    }
+
+    bool DirtyPageTracker::supported() {
+        return false;
+    }
+
+    void DirtyPageTracker::reservePool(std::size_t pages) {
+    }
+
+    void DirtyPageTracker::arm(Heap& heap) {
+        throw DirtyPageTrackingNotSupported("wasmint was built without support for dirty page tracking");
+    }
+
+    void DirtyPageTracker::disarm() {
+    }
+
+    void DirtyPageTracker::release() {
+    }
+
+    void DirtyPageTracker::protect() {
+    }
+
+    void DirtyPageTracker::flush(HeapPatch& patch) const {
+    }
+
+    bool DirtyPageTracker::handleWriteFault(const void* address) {
+        return false;
+    }
+
+#endif
+}
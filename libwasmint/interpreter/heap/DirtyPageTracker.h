@@ -0,0 +1,140 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_DIRTYPAGETRACKER_H
+#define WASMINT_DIRTYPAGETRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <ExceptionWithMessage.h>
+
+namespace wasmint {
+
+    ExceptionMessage(DirtyPageTrackingNotSupported)
+    ExceptionMessage(CantProtectHeapPages)
+
+    class Heap;
+    class HeapPatch;
+
+    /**
+     * Finds the pages of a heap that are modified with the memory protection of the operating
+     * system instead of a callback on every store.
+     *
+     * When armed, all pages of the heap are made read-only. The first store to a page triggers
+     * a write fault; the fault handler copies the unmodified page into a pool, marks the page as
+     * dirty and makes it writable again, so all further stores to the page run at full speed.
+     * flush() then copies the saved pages into a HeapPatch.
+     *
+     * The heap notifies its tracker before and after it reallocates its memory, so the tracker
+     * can release and restore the protection of the pages.
+     */
+    class DirtyPageTracker {
+
+        Heap* heap_ = nullptr;
+        std::size_t pageSize_ = 0;
+
+        // the currently protected memory, which is the memory of heap_ if the tracker is armed
+        uint8_t* protectedStart_ = nullptr;
+        std::size_t protectedPages_ = 0;
+
+        // the number of pages the heap had when the tracker was armed, only those are tracked
+        std::size_t trackedPages_ = 0;
+
+        // the n-th page of the heap is saved at n * pageSize_, only touched pages use memory
+        uint8_t* pool_ = nullptr;
+        std::size_t poolPages_ = 0;
+
+        std::vector<uint64_t> dirtyBitmap_;
+        // indexes of the dirty pages, preallocated as the fault handler can't allocate memory
+        std::vector<std::size_t> dirtyPages_;
+        std::size_t dirtyPageCount_ = 0;
+
+        bool isDirty(std::size_t page) const {
+            return (dirtyBitmap_[page / 64] & (uint64_t(1) << (page % 64))) != 0;
+        }
+
+        void reservePool(std::size_t pages);
+
+        DirtyPageTracker(const DirtyPageTracker& other) = delete;
+        DirtyPageTracker& operator=(const DirtyPageTracker& other) = delete;
+
+    public:
+        DirtyPageTracker() {
+        }
+
+        ~DirtyPageTracker();
+
+        /**
+         * If this platform supports finding dirty pages via memory protection.
+         */
+        static bool supported();
+
+        /**
+         * Starts tracking the given heap. All pages are write-protected and the
+         * set of dirty pages is cleared.
+         */
+        void arm(Heap& heap);
+
+        /**
+         * Stops tracking and makes the whole heap writable again.
+         */
+        void disarm();
+
+        bool armed() const {
+            return heap_ != nullptr;
+        }
+
+        /**
+         * Makes all protected pages writable without forgetting which pages are dirty.
+         * Stores to the heap are not recorded until protect() is called.
+         */
+        void release();
+
+        /**
+         * Write-protects all pages of the heap that aren't dirty yet.
+         */
+        void protect();
+
+        /**
+         * Backs up all pages that became dirty since the tracker was armed in the given patch.
+         * The patch has to use the page size as its chunk size. Pages that are already saved in
+         * the patch are skipped, so the same pages can be flushed multiple times.
+         */
+        void flush(HeapPatch& patch) const;
+
+        /**
+         * Called by the fault handler. Returns false if the address doesn't belong to this tracker.
+         */
+        bool handleWriteFault(const void* address);
+
+        std::size_t pageSize() const {
+            return pageSize_;
+        }
+
+        std::size_t dirtyPageCount() const {
+            return dirtyPageCount_;
+        }
+
+        std::size_t memoryUsage() const {
+            return dirtyPageCount_ * pageSize_ + dirtyPages_.capacity() * sizeof(std::size_t)
+                   + dirtyBitmap_.capacity() * sizeof(uint64_t);
+        }
+    };
+}
+
+#endif //WASMINT_DIRTYPAGETRACKER_H
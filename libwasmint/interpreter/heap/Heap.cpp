@@ -21,11 +21,16 @@
 namespace wasmint {
 
     void Heap::serialize(ByteOutputStream& stream) const {
-        stream.writeBytes(data_);
+        stream.writeBytes(std::vector<uint8_t>(data_.data(), data_.data() + data_.size()));
     }
 
     void Heap::setState(ByteInputStream& stream) {
-        data_ = stream.getBytes();
+        std::vector<uint8_t> bytes = stream.getBytes();
+        notifySnapshots(Interval::withEnd(0, data_.size()));
+        releasePages();
+        data_.assign(bytes.data(), bytes.size());
+        rehash();
+        protectPages();
     }
 
 
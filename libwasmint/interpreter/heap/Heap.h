@@ -26,10 +26,16 @@
 #include <serialization/ByteInputStream.h>
 #include <serialization/ByteOutputStream.h>
 #include "../SafeAddition.h"
+#include "../StateHash.h"
 #include "Interval.h"
 #include "HeapObserver.h"
+#include "DirtyPageTracker.h"
+#include "HeapSnapshot.h"
+#include "HeapMemory.h"
+#include "HeapImage.h"
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 namespace wasmint {
 
@@ -41,32 +47,144 @@ namespace wasmint {
 
     class Heap {
 
+        friend class HeapSnapshot;
+
         std::size_t maxSize_ = 1073741824;
-        std::vector<uint8_t> data_;
+        // page aligned so the pages of the heap can be write-protected by a DirtyPageTracker
+        HeapMemory data_;
 
         // 64 KiB as stated in the design documents
         const static std::size_t pageSize_ = 65536;
 
-        HeapObserver* observer_ = nullptr;
+        std::vector<HeapObserver*> observers_;
+        DirtyPageTracker* pageTracker_ = nullptr;
+        HeapSnapshot* newestSnapshot_ = nullptr;
+
+        bool hashing_ = false;
+        uint64_t hash_ = 0;
+
+        /**
+         * The hash of the heap is the sum of all 8 byte words multiplied with a weight for their
+         * position. A store only has to subtract the modified words before and add them again
+         * afterwards, so the hash can be maintained while the heap is modified.
+         */
+        uint64_t wordsHash(std::size_t start, std::size_t end) const {
+            uint64_t result = 0;
+            std::size_t size = data_.size();
+            if (end > size)
+                end = size;
+            for (std::size_t word = start / 8; word * 8 < end; word++) {
+                uint64_t value = 0;
+                std::memcpy(&value, data_.data() + word * 8, std::min<std::size_t>(8, size - word * 8));
+                if (value != 0)
+                    result += value * (StateHash::mix(word) | 1);
+            }
+            return result;
+        }
+
+        void unhashRange(std::size_t start, std::size_t end) {
+            if (hashing_)
+                hash_ -= wordsHash(start, end);
+        }
+
+        void hashRange(std::size_t start, std::size_t end) {
+            if (hashing_)
+                hash_ += wordsHash(start, end);
+        }
+
+        void notifyObservers(const Interval& changedInterval) {
+            for (HeapObserver* observer : observers_) {
+                observer->preChanged(*this, changedInterval);
+            }
+        }
+
+        void rehash() {
+            if (hashing_)
+                hash_ = wordsHash(0, data_.size());
+        }
+
+        // lets the newest snapshot save the chunks in the interval before they are modified
+        void notifySnapshots(const Interval& changedInterval) {
+            if (newestSnapshot_)
+                newestSnapshot_->preChanged(changedInterval);
+        }
+
+        // the tracker has to unprotect the memory before it's reallocated
+        void releasePages() {
+            if (pageTracker_)
+                pageTracker_->release();
+        }
+
+        void protectPages() {
+            if (pageTracker_)
+                pageTracker_->protect();
+        }
 
     public:
         Heap() {
         }
 
+        Heap(const Heap& other) : maxSize_(other.maxSize_), data_(other.data_), observers_(other.observers_),
+                                   hashing_(other.hashing_), hash_(other.hash_) {
+        }
+
+        /**
+         * Assigning a heap doesn't notify the observers or record dirty pages. The
+         * page tracker and the snapshots stay attached to this heap and aren't copied.
+         */
+        Heap& operator=(const Heap& other) {
+            if (this != &other) {
+                notifySnapshots(Interval::withEnd(0, data_.size()));
+                releasePages();
+                maxSize_ = other.maxSize_;
+                data_ = other.data_;
+                observers_ = other.observers_;
+                rehash();
+                protectPages();
+            }
+            return *this;
+        }
+
+        virtual ~Heap() {
+            if (newestSnapshot_)
+                newestSnapshot_->heapDestroyed();
+            if (pageTracker_)
+                pageTracker_->disarm();
+        }
+
         Heap(std::size_t size) {
             resize(size);
         }
 
         Heap(const wasm_module::HeapData& data) {
             resize(data.startSize());
-            std::fill(data_.begin(), data_.end(), 0);
 
             for (const wasm_module::HeapSegment& segment : data.segments()) {
-                std::copy(segment.data().begin(), segment.data().end(), data_.begin() + segment.offset());
+                std::copy(segment.data().begin(), segment.data().end(), data_.data() + segment.offset());
             }
             maxSize_ = data.maxSize();
         }
 
+        /**
+         * Creates a heap that maps the image copy-on-write.
+         */
+        Heap(const HeapImage& image) {
+            useImage(image);
+        }
+
+        /**
+         * Replaces the content of this heap with a copy-on-write mapping of the image.
+         * Like an assignment, this doesn't notify the observers or record dirty pages.
+         */
+        void useImage(const HeapImage& image) {
+            notifySnapshots(Interval::withEnd(0, data_.size()));
+            releasePages();
+            data_.mapImage(image);
+            maxSize_ = image.maxSize();
+            rehash();
+            protectPages();
+        }
+
         std::size_t pageSize() const {
             return pageSize_;
         }
@@ -77,12 +195,21 @@ namespace wasmint {
 
         void setState(ByteInputStream& stream);
 
+        const uint8_t* data() const {
+            return data_.data();
+        }
+
         uint8_t getByte(std::size_t pos) const {
-            return data_[pos];
+            return data_.data()[pos];
         }
 
         void setByte(std::size_t position, uint8_t value) {
-            data_.at(position) = value;
+            notifySnapshots(Interval::withEnd(position, position + 1));
+            if (position >= data_.size())
+                throw OutOfBounds(std::string("Position ") + std::to_string(position));
+            unhashRange(position, position + 1);
+            data_.data()[position] = value;
+            hashRange(position, position + 1);
         }
 
         size_t pageCount() {
@@ -104,15 +231,23 @@ namespace wasmint {
             if (newSize > maxSize_)
                 return false;
 
+            releasePages();
             data_.resize(newSize);
-            std::fill(data_.begin() + oldSize, data_.end(), 0);
+            protectPages();
             return true;
         }
 
         bool shrink(std::size_t size) {
             if (size > data_.size())
                 return false;
-            data_.resize(data_.size() - size);
+            std::size_t newSize = data_.size() - size;
+            notifySnapshots(Interval::withEnd(newSize, data_.size()));
+            unhashRange(newSize, data_.size());
+            releasePages();
+            data_.resize(newSize);
+            protectPages();
+            // the last word is only partially removed
+            hashRange(newSize / 8 * 8, newSize);
             return true;
         }
 
@@ -120,10 +255,18 @@ namespace wasmint {
             if (size > maxSize_) {
                 return false;
             }
-            data_.resize(size, 0);
+            bool shrinks = size < data_.size();
+            if (shrinks) {
+                notifySnapshots(Interval::withEnd(size, data_.size()));
+                unhashRange(size, data_.size());
+            }
+            releasePages();
+            data_.resize(size);
+            if (shrinks)
+                hashRange(size / 8 * 8, size);
 #ifdef WASMINT_FUTURE_COMPABILITY
             if (size % pageSize_ == 0) {
-                data_.resize(size, 0);
+                data_.resize(size);
             } else {
                 // round up to next page
                 std::size_t pages = size % pageSize_;
@@ -131,6 +274,7 @@ namespace wasmint {
                 data_.resize(pages * pageSize_);
             }
 #endif
+            protectPages();
             return true;
         }
 
@@ -147,9 +291,32 @@ namespace wasmint {
                                   + " + size " + std::to_string(bytes.size()));
             }
 
-            for (std::size_t i = offset; i < offset + bytes.size(); i++) {
-                data_[i] = bytes[i - offset];
+            notifySnapshots(Interval::withEnd(offset, end));
+            unhashRange(offset, end);
+            std::memcpy(data_.data() + offset, bytes.data(), bytes.size());
+            hashRange(offset, end);
+        }
+
+        /**
+         * Copies the bytes into the heap without notifying the observers.
+         */
+        void setBytes(std::size_t offset, const uint8_t* bytes, std::size_t size) {
+            std::size_t end;
+
+            if (safeSizeTAddition(offset, size, &end)) {
+                throw OverFlowInHeapAccess(std::string("Offset ") + std::to_string(offset)
+                                           + " + size " + std::to_string(size));
+            }
+
+            if (end > data_.size()) {
+                throw OutOfBounds(std::string("Offset ") + std::to_string(offset)
+                                  + " + size " + std::to_string(size));
             }
+
+            notifySnapshots(Interval::withEnd(offset, end));
+            unhashRange(offset, end);
+            std::memcpy(data_.data() + offset, bytes, size);
+            hashRange(offset, end);
         }
 
         template<typename T>
@@ -169,10 +336,12 @@ namespace wasmint {
 
             std::size_t start = offset + staticOffset;
 
-            if (observer_)
-                observer_->preChanged(*this, Interval::withEnd(start, start + sizeof(T)));
+            notifyObservers(Interval::withEnd(start, start + sizeof(T)));
+            notifySnapshots(Interval::withEnd(start, start + sizeof(T)));
 
+            unhashRange(start, start + sizeof(T));
             std::memcpy(data_.data() + start, &value, sizeof(T));
+            hashRange(start, start + sizeof(T));
 
             return true;
         }
@@ -189,9 +358,11 @@ namespace wasmint {
                 return false;
             }
 
-            if (observer_)
-                observer_->preChanged(*this, Interval::withEnd(offset, offset + sizeof(T)));
+            notifyObservers(Interval::withEnd(offset, offset + sizeof(T)));
+            notifySnapshots(Interval::withEnd(offset, offset + sizeof(T)));
+            unhashRange(offset, offset + sizeof(T));
             std::memcpy(data_.data() + offset, &value, sizeof(T));
+            hashRange(offset, offset + sizeof(T));
 
             return true;
         }
@@ -247,13 +418,7 @@ namespace wasmint {
                                                            + " + size " + std::to_string(size));
             }
 
-            std::vector<uint8_t> result;
-            result.resize(size);
-
-            for (std::size_t i = offset; i < offset + size; i++) {
-                result[i - offset] = data_[i];
-            }
-            return result;
+            return std::vector<uint8_t>(data_.data() + offset, data_.data() + end);
         }
 
         std::size_t size() const {
@@ -282,16 +447,61 @@ namespace wasmint {
             return std::memcmp(data_.data() + start, other.data_.data() + start, end - start) == 0;
         }
 
-        void removeObserver() {
-            observer_ = nullptr;
+        /**
+         * Maintains the hash of the heap with every modification, so hash() only needs
+         * constant time. Costs a few multiplications per store while enabled.
+         */
+        void hashing(bool enabled) {
+            hashing_ = enabled;
+            rehash();
+        }
+
+        bool hashing() const {
+            return hashing_;
+        }
+
+        /**
+         * Hash of the content. Heaps with equal content have the same hash.
+         */
+        uint64_t hash() const {
+            if (hashing_)
+                return hash_;
+            return wordsHash(0, data_.size());
         }
 
+        /**
+         * The observers are notified in the order in which they were attached before
+         * a value is stored. Attaching an observer twice has no effect.
+         */
         void attachObserver(HeapObserver& newObserver) {
-            if (observer_) {
-                throw OnlyOneObserverSupported("Only one observer is supported right now.");
-            } else {
-                observer_ = &newObserver;
+            if (std::find(observers_.begin(), observers_.end(), &newObserver) == observers_.end())
+                observers_.push_back(&newObserver);
+        }
+
+        /**
+         * Returns false if the observer wasn't attached.
+         */
+        bool removeObserver(HeapObserver& observer) {
+            auto iter = std::remove(observers_.begin(), observers_.end(), &observer);
+            if (iter == observers_.end())
+                return false;
+            observers_.erase(iter, observers_.end());
+            return true;
+        }
+
+        std::size_t observerCount() const {
+            return observers_.size();
+        }
+
+        void attachPageTracker(DirtyPageTracker& tracker) {
+            if (pageTracker_ && pageTracker_ != &tracker) {
+                throw OnlyOneObserverSupported("Only one page tracker is supported right now.");
             }
+            pageTracker_ = &tracker;
+        }
+
+        void removePageTracker() {
+            pageTracker_ = nullptr;
         }
     };
 
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "HeapImage.h"
+#include "Heap.h"
+
+#ifdef WASMINT_HAVE_MMAP
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#endif
+
+namespace wasmint {
+
+#ifdef WASMINT_HAVE_MMAP
+    static int createAnonymousFile() {
+#ifdef SYS_memfd_create
+        int fd = (int) syscall(SYS_memfd_create, "wasmint-heap-image", 1 /* MFD_CLOEXEC */);
+        if (fd >= 0)
+            return fd;
+#endif
+        char path[] = "/tmp/wasmint-heap-image-XXXXXX";
+        int tempFile = mkstemp(path);
+        if (tempFile >= 0)
+            unlink(path);
+        return tempFile;
+    }
+#endif
+
+    HeapImage::HeapImage(const Heap& heap) : size_(heap.size()), maxSize_(heap.maxSize()) {
+#ifdef WASMINT_HAVE_MMAP
+        fileDescriptor_ = createAnonymousFile();
+        if (fileDescriptor_ < 0)
+            throw CantCreateHeapImage("Can't create a file for the heap image");
+
+        std::size_t pageSize = systemPageSize();
+        std::size_t fileSize = ((size_ + pageSize - 1) / pageSize) * pageSize;
+        if (ftruncate(fileDescriptor_, (off_t) fileSize) != 0) {
+            close(fileDescriptor_);
+            throw CantCreateHeapImage("Can't resize the file for the heap image to " + std::to_string(fileSize));
+        }
+
+        // the file is already zero, so pages that only contain zeros are left sparse
+        for (std::size_t offset = 0; offset < size_; offset += pageSize) {
+            std::size_t length = std::min(pageSize, size_ - offset);
+            const uint8_t* page = heap.data() + offset;
+            if (page[0] == 0 && std::memcmp(page, page + 1, length - 1) == 0)
+                continue;
+
+            std::size_t written = 0;
+            while (written < length) {
+                ssize_t result = pwrite(fileDescriptor_, page + written, length - written, (off_t) (offset + written));
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0) {
+                    close(fileDescriptor_);
+                    throw CantCreateHeapImage("Can't write the heap image");
+                }
+                written += (std::size_t) result;
+            }
+        }
+#else
+        bytes_.assign(heap.data(), heap.data() + size_);
+#endif
+    }
+
+    HeapImage::~HeapImage() {
+#ifdef WASMINT_HAVE_MMAP
+        close(fileDescriptor_);
+#endif
+    }
+}
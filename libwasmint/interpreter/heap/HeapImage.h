@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_HEAPIMAGE_H
+#define WASMINT_HEAPIMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <ExceptionWithMessage.h>
+
+namespace wasmint {
+
+    ExceptionMessage(CantCreateHeapImage)
+
+    class Heap;
+
+    /**
+     * The frozen content of a heap, for example after the data segments were loaded and an
+     * initialization function was executed. Heaps created from the image map it copy-on-write,
+     * so creating a heap from an image doesn't copy anything and each heap only allocates
+     * memory for the pages it modifies. Modifying those heaps never changes the image.
+     *
+     * On unix systems the image is stored in an anonymous file. Other systems copy the image.
+     */
+    class HeapImage {
+
+        int fileDescriptor_ = -1;
+        std::size_t size_ = 0;
+        std::size_t maxSize_ = 0;
+        std::vector<uint8_t> bytes_;
+
+        HeapImage(const HeapImage& other) = delete;
+        HeapImage& operator=(const HeapImage& other) = delete;
+
+    public:
+        explicit HeapImage(const Heap& heap);
+
+        ~HeapImage();
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        std::size_t maxSize() const {
+            return maxSize_;
+        }
+
+        int fileDescriptor() const {
+            return fileDescriptor_;
+        }
+
+        const std::vector<uint8_t>& bytes() const {
+            return bytes_;
+        }
+    };
+}
+
+#endif //WASMINT_HEAPIMAGE_H
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "HeapMemory.h"
+#include "HeapImage.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <algorithm>
+
+#ifdef WASMINT_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#if defined(WASMINT_HAVE_MMAP) || defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define WASMINT_HAVE_SYSCONF
+#endif
+
+namespace wasmint {
+
+    std::size_t systemPageSize() {
+#ifdef WASMINT_HAVE_SYSCONF
+        static const std::size_t pageSize = (std::size_t) sysconf(_SC_PAGESIZE);
+        return pageSize;
+#else
+        return 4096;
+#endif
+    }
+
+    static std::size_t roundUpToPages(std::size_t size) {
+        std::size_t pageSize = systemPageSize();
+        return ((size + pageSize - 1) / pageSize) * pageSize;
+    }
+
+    HeapMemory::HeapMemory(const HeapMemory& other) {
+        assign(other.data_, other.size_);
+    }
+
+    HeapMemory& HeapMemory::operator=(const HeapMemory& other) {
+        if (this != &other)
+            assign(other.data_, other.size_);
+        return *this;
+    }
+
+    HeapMemory::~HeapMemory() {
+        release();
+    }
+
+    void HeapMemory::allocate(std::size_t capacity) {
+        data_ = nullptr;
+        capacity_ = 0;
+        if (capacity == 0)
+            return;
+#ifdef WASMINT_HAVE_MMAP
+        void* memory = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+            throw std::bad_alloc();
+        data_ = (uint8_t*) memory;
+#else
+        // one additional page to align the start and to remember the pointer returned by malloc
+        std::size_t pageSize = systemPageSize();
+        void* memory = std::calloc(capacity + pageSize, 1);
+        if (memory == nullptr)
+            throw std::bad_alloc();
+        uintptr_t start = ((uintptr_t) memory + sizeof(void*) + pageSize - 1) / pageSize * pageSize;
+        ((void**) start)[-1] = memory;
+        data_ = (uint8_t*) start;
+#endif
+        capacity_ = capacity;
+    }
+
+    void HeapMemory::release() {
+        if (data_ != nullptr) {
+#ifdef WASMINT_HAVE_MMAP
+            munmap(data_, capacity_);
+#else
+            std::free(((void**) data_)[-1]);
+#endif
+        }
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    void HeapMemory::resize(std::size_t size) {
+        if (size <= capacity_) {
+            if (size > size_)
+                std::memset(data_ + size_, 0, size - size_);
+            size_ = size;
+            return;
+        }
+
+        // fresh memory is already zeroed, so only the old content has to be copied
+        HeapMemory resized;
+        resized.allocate(roundUpToPages(size));
+        if (size_ != 0)
+            std::memcpy(resized.data_, data_, size_);
+        resized.size_ = size;
+
+        std::swap(data_, resized.data_);
+        std::swap(size_, resized.size_);
+        std::swap(capacity_, resized.capacity_);
+    }
+
+    void HeapMemory::assign(const uint8_t* bytes, std::size_t size) {
+        if (size > capacity_) {
+            release();
+            allocate(roundUpToPages(size));
+        }
+        if (size != 0)
+            std::memcpy(data_, bytes, size);
+        size_ = size;
+    }
+
+    void HeapMemory::mapImage(const HeapImage& image) {
+        release();
+#ifdef WASMINT_HAVE_MMAP
+        std::size_t capacity = roundUpToPages(image.size());
+        if (capacity != 0) {
+            void* memory = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE, image.fileDescriptor(), 0);
+            if (memory == MAP_FAILED)
+                throw std::bad_alloc();
+            data_ = (uint8_t*) memory;
+            capacity_ = capacity;
+        }
+        size_ = image.size();
+#else
+        assign(image.bytes().data(), image.size());
+#endif
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_HEAPMEMORY_H
+#define WASMINT_HEAPMEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wasmint {
+
+    class HeapImage;
+
+    /**
+     * The size of a page of the operating system, or 4096 on systems without sysconf.
+     */
+    std::size_t systemPageSize();
+
+    /**
+     * The memory that stores the content of a heap. It starts at a page boundary and
+     * is padded to whole pages, so the pages can be protected without touching anything
+     * else. On unix systems the memory is mapped from the kernel, so new memory is zeroed
+     * lazily and a HeapImage can be mapped copy-on-write.
+     */
+    class HeapMemory {
+
+        uint8_t* data_ = nullptr;
+        std::size_t size_ = 0;
+        // the number of usable bytes, always a multiple of the page size
+        std::size_t capacity_ = 0;
+
+        void allocate(std::size_t capacity);
+        void release();
+
+    public:
+        HeapMemory() {
+        }
+
+        HeapMemory(const HeapMemory& other);
+
+        HeapMemory& operator=(const HeapMemory& other);
+
+        ~HeapMemory();
+
+        uint8_t* data() {
+            return data_;
+        }
+
+        const uint8_t* data() const {
+            return data_;
+        }
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        /**
+         * Changes the size. Bytes that are added are zero.
+         */
+        void resize(std::size_t size);
+
+        void assign(const uint8_t* bytes, std::size_t size);
+
+        /**
+         * Replaces the content with a private copy-on-write mapping of the image.
+         */
+        void mapImage(const HeapImage& image);
+    };
+}
+
+#endif //WASMINT_HEAPMEMORY_H
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "HeapSnapshot.h"
+#include "Heap.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace wasmint {
+
+    const std::size_t HeapSnapshot::chunkSize;
+
+    HeapSnapshot::HeapSnapshot(Heap& heap) : heap_(&heap), size_(heap.size()) {
+        chunkCount_ = (size_ + chunkSize - 1) / chunkSize;
+        savedChunksBitmap_.resize((chunkCount_ + 63) / 64, 0);
+
+        older_ = heap.newestSnapshot_;
+        if (older_)
+            older_->newer_ = this;
+        heap.newestSnapshot_ = this;
+    }
+
+    HeapSnapshot::~HeapSnapshot() {
+        if (older_) {
+            // the older snapshot shares the chunks that it didn't save itself with us
+            for (const auto& pair : poolOffsets_) {
+                std::size_t chunkIndex = pair.first;
+                if (chunkIndex < older_->chunkCount_ && !older_->isSaved(chunkIndex)) {
+                    older_->saveChunk(chunkIndex, pool_.data() + pair.second, chunkSize);
+                }
+            }
+            older_->newer_ = newer_;
+        }
+        if (newer_) {
+            newer_->older_ = older_;
+        } else if (heap_) {
+            heap_->newestSnapshot_ = older_;
+        }
+    }
+
+    void HeapSnapshot::saveChunk(std::size_t chunkIndex, const uint8_t* data, std::size_t length) {
+        savedChunksBitmap_[chunkIndex / 64] |= uint64_t(1) << (chunkIndex % 64);
+        std::size_t offset = pool_.size();
+        pool_.resize(offset + chunkSize, 0);
+        std::memcpy(pool_.data() + offset, data, length);
+        poolOffsets_[chunkIndex] = offset;
+    }
+
+    const uint8_t* HeapSnapshot::chunkData(std::size_t chunkIndex) const {
+        for (const HeapSnapshot* snapshot = this; snapshot != nullptr; snapshot = snapshot->newer_) {
+            if (chunkIndex < snapshot->chunkCount_ && snapshot->isSaved(chunkIndex)) {
+                return snapshot->pool_.data() + snapshot->poolOffsets_.find(chunkIndex)->second;
+            }
+        }
+        // nobody saved the chunk, so it wasn't modified since this snapshot was taken
+        assert(heap_ != nullptr);
+        return heap_->data() + chunkIndex * chunkSize;
+    }
+
+    std::size_t HeapSnapshot::chunkLength(std::size_t chunkIndex) const {
+        return std::min(chunkSize, size_ - chunkIndex * chunkSize);
+    }
+
+    void HeapSnapshot::preChanged(const Interval& changedInterval) {
+        if (heap_ == nullptr || changedInterval.start() >= size_ || changedInterval.size() == 0)
+            return;
+
+        std::size_t firstChunk = changedInterval.start() / chunkSize;
+        std::size_t lastChunk = (std::min(changedInterval.end(), size_) - 1) / chunkSize;
+
+        for (std::size_t chunkIndex = firstChunk; chunkIndex <= lastChunk; chunkIndex++) {
+            if (!isSaved(chunkIndex)) {
+                std::size_t start = chunkIndex * chunkSize;
+                saveChunk(chunkIndex, heap_->data() + start, std::min(chunkSize, heap_->size() - start));
+            }
+        }
+    }
+
+    void HeapSnapshot::heapDestroyed() {
+        preChanged(Interval::withEnd(0, std::min(size_, heap_->size())));
+        for (HeapSnapshot* snapshot = this; snapshot != nullptr; snapshot = snapshot->older_) {
+            snapshot->heap_ = nullptr;
+        }
+    }
+
+    bool HeapSnapshot::equalRange(const Heap& other, std::size_t start, std::size_t end) const {
+        if (end > size_) {
+            end = size_;
+            if (other.size() != size_)
+                return false;
+        }
+        if (end > other.size()) {
+            end = other.size();
+            if (other.size() != size_)
+                return false;
+        }
+        std::size_t position = start;
+        while (position < end) {
+            std::size_t chunkIndex = position / chunkSize;
+            std::size_t chunkEnd = std::min((chunkIndex + 1) * chunkSize, end);
+            const uint8_t* data = chunkData(chunkIndex) + (position - chunkIndex * chunkSize);
+            if (std::memcmp(data, other.data() + position, chunkEnd - position) != 0)
+                return false;
+            position = chunkEnd;
+        }
+        return true;
+    }
+
+    bool HeapSnapshot::operator==(const Heap& heap) const {
+        if (heap.size() != size_)
+            return false;
+        return equalRange(heap, 0, size_);
+    }
+
+    void HeapSnapshot::read(std::size_t offset, std::size_t size, uint8_t* target) const {
+        std::size_t end = offset + size;
+        assert(end <= size_);
+        std::size_t position = offset;
+        while (position < end) {
+            std::size_t chunkIndex = position / chunkSize;
+            std::size_t chunkEnd = std::min((chunkIndex + 1) * chunkSize, end);
+            const uint8_t* data = chunkData(chunkIndex) + (position - chunkIndex * chunkSize);
+            std::memcpy(target + (position - offset), data, chunkEnd - position);
+            position = chunkEnd;
+        }
+    }
+
+    void HeapSnapshot::restore(Heap& heap) const {
+        heap.resize(size_);
+
+        // writing the heap can save chunks in the newest snapshot, so we copy them out first
+        std::vector<uint8_t> buffer(chunkSize);
+
+        if (&heap != heap_) {
+            for (std::size_t chunkIndex = 0; chunkIndex < chunkCount_; chunkIndex++) {
+                std::size_t length = chunkLength(chunkIndex);
+                std::memcpy(buffer.data(), chunkData(chunkIndex), length);
+                heap.setBytes(chunkIndex * chunkSize, buffer.data(), length);
+            }
+            return;
+        }
+
+        // only chunks that were saved by this or a newer snapshot were modified
+        std::vector<std::size_t> modifiedChunks;
+        for (const HeapSnapshot* snapshot = this; snapshot != nullptr; snapshot = snapshot->newer_) {
+            for (const auto& pair : snapshot->poolOffsets_) {
+                if (pair.first < chunkCount_)
+                    modifiedChunks.push_back(pair.first);
+            }
+        }
+        std::sort(modifiedChunks.begin(), modifiedChunks.end());
+        modifiedChunks.erase(std::unique(modifiedChunks.begin(), modifiedChunks.end()), modifiedChunks.end());
+
+        for (std::size_t chunkIndex : modifiedChunks) {
+            std::size_t length = chunkLength(chunkIndex);
+            std::memcpy(buffer.data(), chunkData(chunkIndex), length);
+            heap.setBytes(chunkIndex * chunkSize, buffer.data(), length);
+        }
+    }
+}
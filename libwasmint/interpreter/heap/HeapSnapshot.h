@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_HEAPSNAPSHOT_H
+#define WASMINT_HEAPSNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include "Interval.h"
+
+namespace wasmint {
+
+    class Heap;
+
+    /**
+     * A copy-on-write snapshot of a heap. Taking a snapshot doesn't copy the heap; instead the
+     * heap notifies its newest snapshot before a chunk is modified the first time and the
+     * snapshot saves the original content of that chunk.
+     *
+     * All snapshots of a heap form a chain from the oldest to the newest one. Only the newest
+     * snapshot is notified about changes. An older snapshot finds the content of a chunk in
+     * itself, in the next newer snapshot that saved the chunk, or in the heap if no snapshot
+     * saved it. If a snapshot is destroyed, its chunks are moved to the next older snapshot.
+     * If the heap is destroyed, the newest snapshot saves all chunks, so the snapshots stay
+     * valid without the heap.
+     */
+    class HeapSnapshot {
+
+        friend class Heap;
+
+        Heap* heap_;
+        HeapSnapshot* older_ = nullptr;
+        HeapSnapshot* newer_ = nullptr;
+
+        std::size_t size_;
+        std::size_t chunkCount_;
+
+        // one bit per chunk, set if the chunk is saved in the pool
+        std::vector<uint64_t> savedChunksBitmap_;
+        std::unordered_map<std::size_t, std::size_t> poolOffsets_;
+        std::vector<uint8_t> pool_;
+
+        bool isSaved(std::size_t chunkIndex) const {
+            return (savedChunksBitmap_[chunkIndex / 64] & (uint64_t(1) << (chunkIndex % 64))) != 0;
+        }
+
+        void saveChunk(std::size_t chunkIndex, const uint8_t* data, std::size_t length);
+
+        /**
+         * The content of the chunk at the time this snapshot was taken.
+         */
+        const uint8_t* chunkData(std::size_t chunkIndex) const;
+
+        std::size_t chunkLength(std::size_t chunkIndex) const;
+
+        // called by the heap
+        void preChanged(const Interval& changedInterval);
+        void heapDestroyed();
+
+        HeapSnapshot(const HeapSnapshot& other) = delete;
+        HeapSnapshot& operator=(const HeapSnapshot& other) = delete;
+
+    public:
+        static const std::size_t chunkSize = 4096;
+
+        HeapSnapshot(Heap& heap);
+
+        ~HeapSnapshot();
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        /**
+         * Compares the bytes between start and end with the given heap. Behaves like
+         * Heap::equalRange() if the sizes of the heaps differ.
+         */
+        bool equalRange(const Heap& other, std::size_t start, std::size_t end) const;
+
+        bool operator==(const Heap& heap) const;
+
+        bool operator!=(const Heap& heap) const {
+            return !(*this == heap);
+        }
+
+        /**
+         * Sets the heap to the content of this snapshot. If the snapshot was taken from this heap,
+         * only the chunks that were modified since then are written.
+         */
+        void restore(Heap& heap) const;
+
+        /**
+         * Copies the content of the snapshot into the given buffer.
+         */
+        void read(std::size_t offset, std::size_t size, uint8_t* target) const;
+
+        std::size_t savedChunks() const {
+            return poolOffsets_.size();
+        }
+
+        std::size_t memoryUsage() const {
+            return sizeof(HeapSnapshot) + pool_.capacity() + savedChunksBitmap_.capacity() * sizeof(uint64_t)
+                   + poolOffsets_.size() * 2 * sizeof(std::size_t);
+        }
+    };
+}
+
+#endif //WASMINT_HEAPSNAPSHOT_H
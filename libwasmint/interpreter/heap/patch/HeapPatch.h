@@ -21,61 +21,134 @@
 #include <stdexcept>
 #include <vector>
 #include <cstring>
-#include <set>
-#include <map>
+#include <algorithm>
 
 #include <interpreter/heap/Heap.h>
 #include <interpreter/heap/Interval.h>
-#include <interpreter/heap/patch/HeapPatchChunk.h>
 
 namespace wasmint {
 
+    ExceptionMessage(InvalidChunkSize)
+
+    /**
+     * Backs up the parts of a heap that are modified so they can be restored later.
+     *
+     * The heap is divided into chunks of chunkSize bytes. Before a chunk is modified the first
+     * time, its content is copied to the end of a contiguous pool. A bitmap with one bit per
+     * chunk remembers which chunks were already saved, so further stores to the same chunk
+     * only have to test a single bit.
+     */
     class HeapPatch {
 
-        std::size_t heapSize_;
+        std::size_t heapSize_ = 0;
+        std::size_t chunkSize_ = defaultChunkSize;
+
+        // one bit per chunk of the heap, set if the chunk is saved in the pool
+        std::vector<uint64_t> savedChunksBitmap_;
+        // the indexes of the saved chunks in the order in which they are stored in the pool
+        std::vector<std::size_t> savedChunks_;
+        // the n-th saved chunk starts at n * chunkSize_
+        std::vector<uint8_t> pool_;
+
+        bool isSaved(std::size_t chunkIndex) const {
+            return (savedChunksBitmap_[chunkIndex / 64] & (uint64_t(1) << (chunkIndex % 64))) != 0;
+        }
 
-        std::map<std::size_t, HeapPatchChunk> chunks_;
-        std::set<std::size_t> modifiedChunks_;
+        std::size_t chunkLength(std::size_t chunkIndex) const {
+            return std::min(chunkSize_, heapSize_ - chunkIndex * chunkSize_);
+        }
+
+        void saveChunk(std::size_t chunkIndex, const uint8_t* data) {
+            savedChunksBitmap_[chunkIndex / 64] |= uint64_t(1) << (chunkIndex % 64);
+            std::size_t offset = pool_.size();
+            pool_.resize(offset + chunkSize_);
+            std::memcpy(pool_.data() + offset, data, chunkLength(chunkIndex));
+            savedChunks_.push_back(chunkIndex);
+        }
 
     public:
-        static const std::size_t chunkSize = 1024;
+        static const std::size_t defaultChunkSize = 1024;
 
         HeapPatch() {
         }
-        HeapPatch(Heap& heap) : heapSize_(heap.size()) {
-            static_assert(sizeof(void*) == sizeof(std::size_t), "std::size_t is not able to hold a pointer value which "
-                "is necessary for the judy array implementation");
+
+        HeapPatch(Heap& heap, std::size_t chunkSize = defaultChunkSize) : heapSize_(heap.size()), chunkSize_(chunkSize) {
+            if (chunkSize == 0) {
+                throw InvalidChunkSize("The chunk size of a heap patch can't be 0");
+            }
+            std::size_t chunkCount = (heapSize_ + chunkSize_ - 1) / chunkSize_;
+            savedChunksBitmap_.resize((chunkCount + 63) / 64, 0);
         }
 
         void applyPatch(Heap& heap) const {
             heap.resize(heapSize_);
-            for (auto& pair : chunks_) {
-                const HeapPatchChunk& chunk = pair.second;
-                heap.setBytes(chunk.start(), chunk.data());
+            for (std::size_t i = 0; i < savedChunks_.size(); i++) {
+                std::size_t chunkIndex = savedChunks_[i];
+                heap.setBytes(chunkIndex * chunkSize_, pool_.data() + i * chunkSize_, chunkLength(chunkIndex));
             }
         }
 
-        void preHeapChanged(const Heap& heap, Interval changedInterval) {
+        void preHeapChanged(const Heap& heap, const Interval& changedInterval) {
             if (changedInterval.start() >= heapSize_)
                 return;
 
-            std::size_t chunkIndex = changedInterval.start() / chunkSize;
-            changedInterval = Interval::withEnd(chunkIndex * chunkSize, (chunkIndex + 1) * chunkSize);
-            if (changedInterval.end() > heapSize_) {
-                changedInterval.end(heapSize_);
-            }
+            std::size_t firstChunk = changedInterval.start() / chunkSize_;
+            std::size_t lastChunk = (std::min(changedInterval.end(), heapSize_) - 1) / chunkSize_;
 
-            modifiedChunks_.insert(chunkIndex);
-            if (chunks_.find(chunkIndex) == chunks_.end()) {
-                HeapPatchChunk& chunk = chunks_[chunkIndex] = HeapPatchChunk(changedInterval);
-                for (std::size_t i = changedInterval.start(); i < changedInterval.end(); i++) {
-                    chunk.setByte(i, heap.getByte(i));
+            for (std::size_t chunkIndex = firstChunk; chunkIndex <= lastChunk; chunkIndex++) {
+                if (!isSaved(chunkIndex)) {
+                    saveChunk(chunkIndex, heap.data() + chunkIndex * chunkSize_);
                 }
             }
         }
 
-        const std::set<std::size_t>& modifiedChunks() const {
-            return modifiedChunks_;
+        /**
+         * Saves the given content as the original content of the chunk unless the chunk was
+         * already saved. Chunks behind the end of the heap are ignored.
+         */
+        void backupChunk(std::size_t chunkIndex, const uint8_t* data) {
+            if (chunkIndex * chunkSize_ >= heapSize_)
+                return;
+            if (!isSaved(chunkIndex))
+                saveChunk(chunkIndex, data);
+        }
+
+        std::size_t chunkSize() const {
+            return chunkSize_;
+        }
+
+        /**
+         * The sorted indexes of all chunks that were modified.
+         */
+        std::vector<std::size_t> modifiedChunks() const {
+            std::vector<std::size_t> result(savedChunks_);
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        /**
+         * Merges the patch that was recorded directly after this one into this patch.
+         * Afterwards this patch restores the heap from the end of the newer patch.
+         */
+        void merge(const HeapPatch& newerPatch) {
+            if (newerPatch.chunkSize_ != chunkSize_) {
+                throw InvalidChunkSize("Can't merge heap patches with different chunk sizes");
+            }
+            for (std::size_t i = 0; i < newerPatch.savedChunks_.size(); i++) {
+                std::size_t chunkIndex = newerPatch.savedChunks_[i];
+                // the heap grew after this patch started, the old heap didn't contain these bytes
+                if (chunkIndex * chunkSize_ >= heapSize_)
+                    continue;
+                // our own backup of a chunk is always older
+                if (isSaved(chunkIndex))
+                    continue;
+                saveChunk(chunkIndex, newerPatch.pool_.data() + i * chunkSize_);
+            }
+        }
+
+        std::size_t memoryUsage() const {
+            return sizeof(HeapPatch) + pool_.capacity() + savedChunks_.capacity() * sizeof(std::size_t)
+                   + savedChunksBitmap_.capacity() * sizeof(uint64_t);
         }
     };
 }
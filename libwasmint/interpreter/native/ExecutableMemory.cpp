@@ -0,0 +1,49 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ExecutableMemory.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+
+namespace wasmint {
+
+    ExecutableMemory::ExecutableMemory(const std::vector<uint8_t>& code) {
+        std::size_t pageSize = (std::size_t) sysconf(_SC_PAGESIZE);
+        mappedSize_ = ((code.size() + pageSize - 1) / pageSize) * pageSize;
+        if (mappedSize_ == 0)
+            mappedSize_ = pageSize;
+
+        void* memory = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw CantAllocateExecutableMemory("mmap of " + std::to_string(mappedSize_) + " bytes failed");
+        }
+        memory_ = (uint8_t*) memory;
+        std::memcpy(memory_, code.data(), code.size());
+
+        if (mprotect(memory_, mappedSize_, PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory_, mappedSize_);
+            throw CantAllocateExecutableMemory("Can't make native code executable");
+        }
+    }
+
+    ExecutableMemory::~ExecutableMemory() {
+        munmap(memory_, mappedSize_);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_EXECUTABLEMEMORY_H
+#define WASMINT_EXECUTABLEMEMORY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <ExceptionWithMessage.h>
+
+namespace wasmint {
+
+    ExceptionMessage(CantAllocateExecutableMemory)
+
+    /**
+     * A block of machine code in its own mapping. The pages are only writable while
+     * the code is copied into them and are switched to read and execute afterwards,
+     * so the mapping is never writable and executable at the same time.
+     */
+    class ExecutableMemory {
+
+        uint8_t* memory_ = nullptr;
+        std::size_t mappedSize_ = 0;
+
+        ExecutableMemory(const ExecutableMemory& other) = delete;
+        ExecutableMemory& operator=(const ExecutableMemory& other) = delete;
+
+    public:
+        ExecutableMemory(const std::vector<uint8_t>& code);
+
+        ~ExecutableMemory();
+
+        const uint8_t* data() const {
+            return memory_;
+        }
+    };
+}
+
+#endif //WASMINT_EXECUTABLEMEMORY_H
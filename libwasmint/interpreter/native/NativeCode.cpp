@@ -0,0 +1,101 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "NativeCode.h"
+
+#include <interpreter/VMThread.h>
+
+namespace wasmint {
+
+    const uint32_t NativeCode::noEntry;
+
+    void NativeContext::load(FunctionFrame& frame) {
+        stackTop = frame.stack().top();
+        stackLimit = frame.stack().limit();
+        variables = frame.variables();
+        heapData = heap->data();
+        heapSize = heap->size();
+    }
+
+    void NativeContext::flushInstructionCount() {
+        (*counter) += executedInstructions;
+        executedInstructions = 0;
+    }
+
+    typedef void (*NativeEntryFunction)(NativeRegisters* registers, const uint8_t* target);
+
+    void NativeCode::run(NativeContext& context, uint32_t address) const {
+        // the code starts with the entry function that loads the registers and jumps to the given target
+        NativeEntryFunction entry = reinterpret_cast<NativeEntryFunction>(reinterpret_cast<uintptr_t>(memory_.data()));
+        entry(&context, memory_.data() + entryOffsets_.at(address));
+        context.flushInstructionCount();
+
+        if (context.exception) {
+            std::exception_ptr exception = context.exception;
+            context.exception = nullptr;
+            std::rethrow_exception(exception);
+        }
+    }
+
+    bool NativeCode::stepInterpreter(NativeRegisters* registers, uint32_t address, uint32_t nextAddress) {
+        NativeContext& context = *static_cast<NativeContext*>(registers);
+        // exceptions can't be unwound through the generated code
+        try {
+            VMThread& thread = *context.thread;
+            FunctionFrame& frame = thread.currentFrame();
+            frame.stack().top(context.stackTop);
+            frame.instructionPointer(address);
+            context.flushInstructionCount();
+
+            std::size_t frameCount = thread.frameCount();
+            frame.step(thread, *context.heap);
+
+            // calls and returns can reallocate the frames, so we check the frame count before touching the frame again
+            if (thread.finished() || thread.frameCount() != frameCount || frame.instructionPointer() != nextAddress
+                || thread.watchpointHit())
+                return false;
+
+            context.load(frame);
+            return true;
+        } catch (...) {
+            context.exception = std::current_exception();
+            return false;
+        }
+    }
+
+    bool NativeCode::growStack(NativeRegisters* registers) {
+        NativeContext& context = *static_cast<NativeContext*>(registers);
+        try {
+            ValueStack& stack = context.thread->currentFrame().stack();
+            stack.top(context.stackTop);
+            stack.reserveSlot();
+            context.stackTop = stack.top();
+            context.stackLimit = stack.limit();
+            return true;
+        } catch (...) {
+            context.exception = std::current_exception();
+            return false;
+        }
+    }
+
+    void NativeCode::leave(NativeRegisters* registers, uint32_t address) {
+        NativeContext& context = *static_cast<NativeContext*>(registers);
+        FunctionFrame& frame = context.thread->currentFrame();
+        frame.stack().top(context.stackTop);
+        frame.instructionPointer(address);
+    }
+}
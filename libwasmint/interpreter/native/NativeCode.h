@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_NATIVECODE_H
+#define WASMINT_NATIVECODE_H
+
+#include <cstdint>
+#include <vector>
+#include <limits>
+#include "ExecutableMemory.h"
+#include "NativeContext.h"
+
+namespace wasmint {
+
+    /**
+     * The x86-64 machine code of a single function.
+     *
+     * The native code works on the same frame state as the interpreter: the instruction pointer
+     * is still a bytecode address and the values live in the ValueStack and variables of the
+     * frame. Because of this execution can switch between the interpreter and the native code
+     * at every instruction boundary.
+     */
+    class NativeCode {
+
+        ExecutableMemory memory_;
+        // maps each bytecode address to the offset of its machine code or noEntry
+        std::vector<uint32_t> entryOffsets_;
+
+    public:
+        static const uint32_t noEntry = std::numeric_limits<uint32_t>::max();
+
+        NativeCode(const std::vector<uint8_t>& code, const std::vector<uint32_t>& entryOffsets)
+                : memory_(code), entryOffsets_(entryOffsets) {
+        }
+
+        bool hasEntry(uint32_t address) const {
+            return address < entryOffsets_.size() && entryOffsets_[address] != noEntry;
+        }
+
+        /**
+         * Executes the native code starting at the given bytecode address until the current frame is
+         * left or an instruction is executed that the native code can't continue after.
+         */
+        void run(NativeContext& context, uint32_t address) const;
+
+        // Runtime helpers called by the generated code
+
+        /**
+         * Executes the instruction at the given address in the interpreter. Returns true if the
+         * native code can continue with the instruction at nextAddress.
+         */
+        static bool stepInterpreter(NativeRegisters* registers, uint32_t address, uint32_t nextAddress);
+
+        /**
+         * Grows the value stack of the current frame. Returns false if an exception occurred.
+         */
+        static bool growStack(NativeRegisters* registers);
+
+        /**
+         * Writes the stack back to the current frame and continues at the given address in the interpreter.
+         */
+        static void leave(NativeRegisters* registers, uint32_t address);
+    };
+}
+
+#endif //WASMINT_NATIVECODE_H
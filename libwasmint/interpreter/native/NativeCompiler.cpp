@@ -0,0 +1,447 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "NativeCompiler.h"
+
+#include <cstddef>
+
+namespace wasmint {
+
+    namespace {
+        const int32_t stackTopOffset = offsetof(NativeRegisters, stackTop);
+        const int32_t stackLimitOffset = offsetof(NativeRegisters, stackLimit);
+        const int32_t variablesOffset = offsetof(NativeRegisters, variables);
+        const int32_t heapDataOffset = offsetof(NativeRegisters, heapData);
+        const int32_t heapSizeOffset = offsetof(NativeRegisters, heapSize);
+        const int32_t executedInstructionsOffset = offsetof(NativeRegisters, executedInstructions);
+
+        // the two uint16_t values in front of the code, see JITCompiler::compile
+        const uint32_t codeHeaderSize = 2 * sizeof(uint16_t);
+
+        template<typename T>
+        uint64_t functionAddress(T function) {
+            return (uint64_t) reinterpret_cast<uintptr_t>(function);
+        }
+    }
+
+    using namespace X86;
+
+    std::shared_ptr<NativeCode> NativeCompiler::compile(const ByteCode& code) {
+        if (code.size() <= codeHeaderSize)
+            return nullptr;
+
+        entryOffsets_.assign(code.size() + 1, NativeCode::noEntry);
+
+        emitEntryAndExit();
+        emitGrowStackStub();
+
+        uint32_t address = codeHeaderSize;
+        while (address < code.size()) {
+            uint32_t start = address;
+            entryOffsets_[start] = (uint32_t) assembler_.position();
+
+            ByteCode::OpcodeWord opcode = code.get<ByteCode::OpcodeWord>(address);
+            address += sizeof(ByteCode::OpcodeWord);
+
+            switch (opcode) {
+                case ByteOpcodes::I32Const:
+                case ByteOpcodes::F32Const:
+                {
+                    uint32_t value = code.get<uint32_t>(address);
+                    address += sizeof(value);
+                    assembler_.increment(RBP);
+                    emitReserveSlot();
+                    assembler_.movImmediate32(RAX, value);
+                    emitPushRax();
+                    break;
+                }
+                case ByteOpcodes::I64Const:
+                case ByteOpcodes::F64Const:
+                {
+                    uint64_t value = code.get<uint64_t>(address);
+                    address += sizeof(value);
+                    assembler_.increment(RBP);
+                    emitReserveSlot();
+                    assembler_.movImmediate64(RAX, value);
+                    emitPushRax();
+                    break;
+                }
+
+                case ByteOpcodes::GetLocal:
+                {
+                    uint32_t index = code.getImmediate(address);
+                    assembler_.increment(RBP);
+                    emitReserveSlot();
+                    assembler_.load64(RAX, R14, (int32_t) (index * sizeof(uint64_t)));
+                    emitPushRax();
+                    break;
+                }
+                case ByteOpcodes::SetLocal:
+                {
+                    uint32_t index = code.getImmediate(address);
+                    assembler_.increment(RBP);
+                    assembler_.subImmediate(R12, 8);
+                    assembler_.load64(RAX, R12, 0);
+                    assembler_.store64(R14, (int32_t) (index * sizeof(uint64_t)), RAX);
+                    break;
+                }
+                case ByteOpcodes::TeeLocal:
+                {
+                    uint32_t index = code.getImmediate(address);
+                    assembler_.increment(RBP);
+                    assembler_.load64(RAX, R12, -8);
+                    assembler_.store64(R14, (int32_t) (index * sizeof(uint64_t)), RAX);
+                    break;
+                }
+                case ByteOpcodes::Drop:
+                    assembler_.increment(RBP);
+                    assembler_.subImmediate(R12, 8);
+                    break;
+                case ByteOpcodes::Nop:
+                    assembler_.increment(RBP);
+                    break;
+
+                case ByteOpcodes::I32Add: emitBinaryOperation(Add, false); break;
+                case ByteOpcodes::I32Sub: emitBinaryOperation(Sub, false); break;
+                case ByteOpcodes::I32And: emitBinaryOperation(And, false); break;
+                case ByteOpcodes::I32Or: emitBinaryOperation(Or, false); break;
+                case ByteOpcodes::I32Xor: emitBinaryOperation(Xor, false); break;
+                case ByteOpcodes::I32Mul: emitMultiplication(false); break;
+                case ByteOpcodes::I64Add: emitBinaryOperation(Add, true); break;
+                case ByteOpcodes::I64Sub: emitBinaryOperation(Sub, true); break;
+                case ByteOpcodes::I64And: emitBinaryOperation(And, true); break;
+                case ByteOpcodes::I64Or: emitBinaryOperation(Or, true); break;
+                case ByteOpcodes::I64Xor: emitBinaryOperation(Xor, true); break;
+                case ByteOpcodes::I64Mul: emitMultiplication(true); break;
+
+                case ByteOpcodes::I32EqualZero: emitEqualZero(false); break;
+                case ByteOpcodes::I32Equal: emitComparison(Equal, false); break;
+                case ByteOpcodes::I32NotEqual: emitComparison(NotEqual, false); break;
+                case ByteOpcodes::I32LessThanSigned: emitComparison(Less, false); break;
+                case ByteOpcodes::I32LessEqualSigned: emitComparison(LessEqual, false); break;
+                case ByteOpcodes::I32LessThanUnsigned: emitComparison(Below, false); break;
+                case ByteOpcodes::I32LessEqualUnsigned: emitComparison(BelowEqual, false); break;
+                case ByteOpcodes::I32GreaterThanSigned: emitComparison(Greater, false); break;
+                case ByteOpcodes::I32GreaterEqualSigned: emitComparison(GreaterEqual, false); break;
+                case ByteOpcodes::I32GreaterThanUnsigned: emitComparison(Above, false); break;
+                case ByteOpcodes::I32GreaterEqualUnsigned: emitComparison(AboveEqual, false); break;
+                case ByteOpcodes::I64EqualZero: emitEqualZero(true); break;
+                case ByteOpcodes::I64Equal: emitComparison(Equal, true); break;
+                case ByteOpcodes::I64NotEqual: emitComparison(NotEqual, true); break;
+                case ByteOpcodes::I64LessThanSigned: emitComparison(Less, true); break;
+                case ByteOpcodes::I64LessEqualSigned: emitComparison(LessEqual, true); break;
+                case ByteOpcodes::I64LessThanUnsigned: emitComparison(Below, true); break;
+                case ByteOpcodes::I64LessEqualUnsigned: emitComparison(BelowEqual, true); break;
+                case ByteOpcodes::I64GreaterThanSigned: emitComparison(Greater, true); break;
+                case ByteOpcodes::I64GreaterEqualSigned: emitComparison(GreaterEqual, true); break;
+                case ByteOpcodes::I64GreaterThanUnsigned: emitComparison(Above, true); break;
+                case ByteOpcodes::I64GreaterEqualUnsigned: emitComparison(AboveEqual, true); break;
+
+                case ByteOpcodes::Branch:
+                {
+                    uint32_t target = code.get<uint32_t>(address);
+                    address += sizeof(target);
+                    assembler_.increment(RBP);
+                    branches_.push_back(std::make_pair(assembler_.jump(), target));
+                    break;
+                }
+                case ByteOpcodes::BranchIf:
+                case ByteOpcodes::BranchIfNot:
+                {
+                    uint32_t target = code.get<uint32_t>(address);
+                    address += sizeof(target);
+                    assembler_.increment(RBP);
+                    assembler_.subImmediate(R12, 8);
+                    assembler_.load32(RAX, R12, 0);
+                    assembler_.alu(Test, false, RAX, RAX);
+                    Condition condition = opcode == ByteOpcodes::BranchIf ? NotEqual : Equal;
+                    branches_.push_back(std::make_pair(assembler_.jumpIf(condition), target));
+                    break;
+                }
+
+                // The signed loads are left to the interpreter as they push the value with its
+                // narrow type and we want to keep a single definition of that behaviour.
+                case ByteOpcodes::I32Load8Unsigned:
+                case ByteOpcodes::I64Load8Unsigned:
+                {
+                    uint32_t offset = code.getImmediate(address);
+                    emitLoad(1, offset, start, address);
+                    break;
+                }
+                case ByteOpcodes::I32Load16Unsigned:
+                case ByteOpcodes::I64Load16Unsigned:
+                {
+                    uint32_t offset = code.getImmediate(address);
+                    emitLoad(2, offset, start, address);
+                    break;
+                }
+                case ByteOpcodes::I32Load:
+                case ByteOpcodes::I64Load32Unsigned:
+                case ByteOpcodes::F32Load:
+                {
+                    uint32_t offset = code.getImmediate(address);
+                    emitLoad(4, offset, start, address);
+                    break;
+                }
+                case ByteOpcodes::I64Load:
+                case ByteOpcodes::F64Load:
+                {
+                    uint32_t offset = code.getImmediate(address);
+                    emitLoad(8, offset, start, address);
+                    break;
+                }
+
+                /******************************************************
+                 ******** Instructions executed by the interpreter ****
+                 ******************************************************/
+                case ByteOpcodes::I32Load8Signed:
+                case ByteOpcodes::I32Load16Signed:
+                case ByteOpcodes::I64Load8Signed:
+                case ByteOpcodes::I64Load16Signed:
+                case ByteOpcodes::I64Load32Signed:
+                case ByteOpcodes::I32Store8:
+                case ByteOpcodes::I32Store16:
+                case ByteOpcodes::I32Store:
+                case ByteOpcodes::I64Store8:
+                case ByteOpcodes::I64Store16:
+                case ByteOpcodes::I64Store32:
+                case ByteOpcodes::I64Store:
+                case ByteOpcodes::F32Store:
+                case ByteOpcodes::F64Store:
+                    code.getImmediate(address);
+                    emitInterpreterCall(start, address);
+                    break;
+
+                case ByteOpcodes::TableSwitch:
+                {
+                    uint32_t tableSize = code.getImmediate(address);
+                    // the jump table and the default target
+                    address += (tableSize + 1) * sizeof(uint32_t);
+                    emitInterpreterCall(start, address);
+                    break;
+                }
+                case ByteOpcodes::Call:
+                {
+                    address += sizeof(uint32_t);
+                    code.getImmediate(address);
+                    emitInterpreterCall(start, address);
+                    break;
+                }
+                case ByteOpcodes::CallImport:
+                {
+                    address += sizeof(uint32_t);
+                    uint32_t parameterSize = code.getImmediate(address);
+                    // the type ids of the parameters
+                    for (uint32_t i = 0; i < parameterSize; i++)
+                        code.getImmediate(address);
+                    emitInterpreterCall(start, address);
+                    break;
+                }
+                case ByteOpcodes::CallIndirect:
+                {
+                    code.getImmediate(address);
+                    code.getImmediate(address);
+                    emitInterpreterCall(start, address);
+                    break;
+                }
+
+                default:
+                    emitInterpreterCall(start, address);
+                    break;
+            }
+        }
+
+        // every function ends with End which leaves the frame, but we never want to run off the code
+        emitLeave(address);
+
+        for (const auto& branch : branches_) {
+            uint32_t target = branch.second;
+            if (target < entryOffsets_.size() && entryOffsets_[target] != NativeCode::noEntry) {
+                assembler_.patch(branch.first, entryOffsets_[target]);
+            } else {
+                assembler_.patch(branch.first, assembler_.position());
+                emitLeave(target);
+            }
+        }
+
+        return std::make_shared<NativeCode>(assembler_.code(), entryOffsets_);
+    }
+
+    void NativeCompiler::emitEntryAndExit() {
+        // void entry(NativeRegisters* registers, const uint8_t* target)
+        assembler_.push(RBP);
+        assembler_.push(R12);
+        assembler_.push(R13);
+        assembler_.push(R14);
+        assembler_.push(R15);
+        // five pushes and the return address keep the stack 16 byte aligned for our calls
+        assembler_.mov(R15, RDI);
+        assembler_.load64(R12, R15, stackTopOffset);
+        assembler_.load64(R13, R15, stackLimitOffset);
+        assembler_.load64(R14, R15, variablesOffset);
+        assembler_.alu(Xor, false, RBP, RBP);
+        assembler_.jump(RSI);
+
+        exitOffset_ = assembler_.position();
+        assembler_.addToMemory(R15, executedInstructionsOffset, RBP);
+        assembler_.pop(R15);
+        assembler_.pop(R14);
+        assembler_.pop(R13);
+        assembler_.pop(R12);
+        assembler_.pop(RBP);
+        assembler_.ret();
+    }
+
+    void NativeCompiler::emitGrowStackStub() {
+        growStackOffset_ = assembler_.position();
+        // realign the stack after the call to this stub
+        assembler_.subImmediate(RSP, 8);
+        assembler_.store64(R15, stackTopOffset, R12);
+        assembler_.mov(RDI, R15);
+        assembler_.movImmediate64(RAX, functionAddress(&NativeCode::growStack));
+        assembler_.call(RAX);
+        assembler_.addImmediate(RSP, 8);
+        assembler_.testByte(RAX);
+        std::size_t failed = assembler_.jumpIf(Equal);
+        assembler_.load64(R12, R15, stackTopOffset);
+        assembler_.load64(R13, R15, stackLimitOffset);
+        assembler_.ret();
+
+        assembler_.patch(failed, assembler_.position());
+        // drop our own return address before leaving
+        assembler_.addImmediate(RSP, 8);
+        assembler_.patch(assembler_.jump(), exitOffset_);
+    }
+
+    void NativeCompiler::emitLeave(uint32_t address) {
+        assembler_.store64(R15, stackTopOffset, R12);
+        assembler_.mov(RDI, R15);
+        assembler_.movImmediate32(RSI, address);
+        assembler_.movImmediate64(RAX, functionAddress(&NativeCode::leave));
+        assembler_.call(RAX);
+        assembler_.patch(assembler_.jump(), exitOffset_);
+    }
+
+    void NativeCompiler::emitInterpreterCall(uint32_t address, uint32_t nextAddress, bool countInstruction) {
+        if (countInstruction)
+            assembler_.increment(RBP);
+        assembler_.addToMemory(R15, executedInstructionsOffset, RBP);
+        assembler_.alu(Xor, false, RBP, RBP);
+        assembler_.store64(R15, stackTopOffset, R12);
+
+        assembler_.mov(RDI, R15);
+        assembler_.movImmediate32(RSI, address);
+        assembler_.movImmediate32(RDX, nextAddress);
+        assembler_.movImmediate64(RAX, functionAddress(&NativeCode::stepInterpreter));
+        assembler_.call(RAX);
+
+        assembler_.testByte(RAX);
+        assembler_.patch(assembler_.jumpIf(Equal), exitOffset_);
+        // the interpreter might have reallocated the stack
+        assembler_.load64(R12, R15, stackTopOffset);
+        assembler_.load64(R13, R15, stackLimitOffset);
+    }
+
+    void NativeCompiler::emitReserveSlot() {
+        assembler_.alu(Cmp, true, R12, R13);
+        std::size_t enoughSpace = assembler_.jumpIf(Below);
+        assembler_.patch(assembler_.call(), growStackOffset_);
+        assembler_.patch(enoughSpace, assembler_.position());
+    }
+
+    void NativeCompiler::emitPushRax() {
+        assembler_.store64(R12, 0, RAX);
+        assembler_.addImmediate(R12, 8);
+    }
+
+    void NativeCompiler::emitBinaryOperation(AluOperation operation, bool wide) {
+        assembler_.increment(RBP);
+        assembler_.subImmediate(R12, 8);
+        if (wide) {
+            assembler_.load64(RCX, R12, 0);
+            assembler_.load64(RAX, R12, -8);
+        } else {
+            assembler_.load32(RCX, R12, 0);
+            assembler_.load32(RAX, R12, -8);
+        }
+        // 32 bit operations clear the upper half of rax, just like the interpreter pushes a uint32_t
+        assembler_.alu(operation, wide, RAX, RCX);
+        assembler_.store64(R12, -8, RAX);
+    }
+
+    void NativeCompiler::emitMultiplication(bool wide) {
+        assembler_.increment(RBP);
+        assembler_.subImmediate(R12, 8);
+        if (wide) {
+            assembler_.load64(RCX, R12, 0);
+            assembler_.load64(RAX, R12, -8);
+        } else {
+            assembler_.load32(RCX, R12, 0);
+            assembler_.load32(RAX, R12, -8);
+        }
+        assembler_.imul(wide, RAX, RCX);
+        assembler_.store64(R12, -8, RAX);
+    }
+
+    void NativeCompiler::emitComparison(Condition condition, bool wide) {
+        assembler_.increment(RBP);
+        assembler_.subImmediate(R12, 8);
+        if (wide) {
+            assembler_.load64(RCX, R12, 0);
+            assembler_.load64(RAX, R12, -8);
+        } else {
+            assembler_.load32(RCX, R12, 0);
+            assembler_.load32(RAX, R12, -8);
+        }
+        assembler_.alu(Cmp, wide, RAX, RCX);
+        assembler_.setAndExtend(condition, RAX);
+        assembler_.store64(R12, -8, RAX);
+    }
+
+    void NativeCompiler::emitEqualZero(bool wide) {
+        assembler_.increment(RBP);
+        if (wide) {
+            assembler_.load64(RAX, R12, -8);
+        } else {
+            assembler_.load32(RAX, R12, -8);
+        }
+        assembler_.alu(Test, wide, RAX, RAX);
+        assembler_.setAndExtend(Equal, RAX);
+        assembler_.store64(R12, -8, RAX);
+    }
+
+    void NativeCompiler::emitLoad(std::size_t size, uint32_t offset, uint32_t address, uint32_t nextAddress) {
+        assembler_.increment(RBP);
+        // rax = address + offset, can't overflow in 64 bit
+        assembler_.load32(RAX, R12, -8);
+        assembler_.movImmediate32(RCX, offset);
+        assembler_.alu(Add, true, RAX, RCX);
+        assembler_.lea(RDX, RAX, (int32_t) size);
+        assembler_.compareWithMemory(RDX, R15, heapSizeOffset);
+        std::size_t outOfBounds = assembler_.jumpIf(Above);
+
+        assembler_.load64(RCX, R15, heapDataOffset);
+        assembler_.loadIndexed(size, RAX, RCX, RAX);
+        assembler_.store64(R12, -8, RAX);
+        std::size_t done = assembler_.jump();
+
+        // let the interpreter produce the trap
+        assembler_.patch(outOfBounds, assembler_.position());
+        emitInterpreterCall(address, nextAddress, false);
+        assembler_.patch(done, assembler_.position());
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_NATIVECOMPILER_H
+#define WASMINT_NATIVECOMPILER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <interpreter/ByteCode.h>
+#include "NativeCode.h"
+#include "X86Assembler.h"
+
+namespace wasmint {
+
+    /**
+     * Translates the bytecode of a function into x86-64 machine code.
+     *
+     * This is a template compiler: every bytecode instruction is translated on its own.
+     * Constants, locals, integer arithmetic, comparisons, branches and loads are emitted
+     * inline. Everything else (calls, stores, GrowMemory, traps, ...) is handed back to the
+     * interpreter through NativeCode::stepInterpreter, so the semantics of those instructions
+     * are defined in one place.
+     *
+     * Register usage of the generated code:
+     *   r15 - the NativeRegisters of the running context
+     *   r14 - the variables of the frame
+     *   r12 - the top of the value stack
+     *   r13 - the limit of the value stack
+     *   rbp - instructions executed since the last helper call
+     */
+    class NativeCompiler {
+
+        X86Assembler assembler_;
+
+        std::vector<uint32_t> entryOffsets_;
+        // position of the displacement of each jump and the bytecode address it targets
+        std::vector<std::pair<std::size_t, uint32_t>> branches_;
+
+        std::size_t exitOffset_ = 0;
+        std::size_t growStackOffset_ = 0;
+
+        void emitEntryAndExit();
+        void emitGrowStackStub();
+        void emitLeave(uint32_t address);
+        void emitInterpreterCall(uint32_t address, uint32_t nextAddress, bool countInstruction = true);
+
+        void emitReserveSlot();
+        void emitPushRax();
+        void emitBinaryOperation(X86::AluOperation operation, bool wide);
+        void emitMultiplication(bool wide);
+        void emitComparison(X86::Condition condition, bool wide);
+        void emitEqualZero(bool wide);
+        void emitLoad(std::size_t size, uint32_t offset, uint32_t address, uint32_t nextAddress);
+
+    public:
+        /**
+         * Returns the machine code for the given bytecode or a nullptr if there is nothing to compile.
+         */
+        std::shared_ptr<NativeCode> compile(const ByteCode& code);
+    };
+}
+
+#endif //WASMINT_NATIVECOMPILER_H
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_NATIVECONTEXT_H
+#define WASMINT_NATIVECONTEXT_H
+
+#include <cstdint>
+#include <exception>
+
+namespace wasmint {
+
+    class VMThread;
+    class Heap;
+    class InstructionCounter;
+    class FunctionFrame;
+
+    /**
+     * The part of the context the generated code accesses directly. The offsets of these
+     * fields are compiled into the machine code, so this struct has to stay a plain struct.
+     */
+    struct NativeRegisters {
+        uint64_t* stackTop = nullptr;
+        uint64_t* stackLimit = nullptr;
+        uint64_t* variables = nullptr;
+        const uint8_t* heapData = nullptr;
+        uint64_t heapSize = 0;
+        // instructions executed since the last time the counter of the VM was updated
+        uint64_t executedInstructions = 0;
+    };
+
+    /**
+     * Everything the runtime helpers need while native code is running on a thread.
+     */
+    struct NativeContext : public NativeRegisters {
+        VMThread* thread;
+        Heap* heap;
+        InstructionCounter* counter;
+        // exception thrown by the interpreter while executing an instruction for the
+        // native code. It's rethrown once the native code has returned.
+        std::exception_ptr exception;
+
+        NativeContext(VMThread& thread, Heap& heap, InstructionCounter& counter)
+                : thread(&thread), heap(&heap), counter(&counter) {
+        }
+
+        /**
+         * Loads the stack, variables and heap of the given frame into the registers.
+         */
+        void load(FunctionFrame& frame);
+
+        /**
+         * Adds the instructions executed by the native code to the instruction counter.
+         */
+        void flushInstructionCount();
+    };
+}
+
+#endif //WASMINT_NATIVECONTEXT_H
@@ -0,0 +1,256 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "X86Assembler.h"
+
+#include <cassert>
+
+namespace wasmint {
+
+    void X86Assembler::int32(uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            byte((uint8_t) (value >> (i * 8)));
+        }
+    }
+
+    void X86Assembler::int64(uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            byte((uint8_t) (value >> (i * 8)));
+        }
+    }
+
+    void X86Assembler::rex(bool wide, unsigned reg, unsigned index, unsigned base) {
+        uint8_t prefix = 0x40;
+        if (wide)
+            prefix |= 0x08;
+        if (reg & 8)
+            prefix |= 0x04;
+        if (index & 8)
+            prefix |= 0x02;
+        if (base & 8)
+            prefix |= 0x01;
+        if (prefix != 0x40)
+            byte(prefix);
+    }
+
+    void X86Assembler::modRmRegister(unsigned reg, unsigned rm) {
+        byte((uint8_t) (0xC0 | ((reg & 7) << 3) | (rm & 7)));
+    }
+
+    void X86Assembler::modRmMemory(unsigned reg, unsigned base, int32_t displacement) {
+        byte((uint8_t) (0x80 | ((reg & 7) << 3) | (base & 7)));
+        // rsp and r12 can only be used as base with a SIB byte
+        if ((base & 7) == X86::RSP)
+            byte(0x24);
+        int32((uint32_t) displacement);
+    }
+
+    void X86Assembler::modRmMemoryIndexed(unsigned reg, unsigned base, unsigned index) {
+        assert((index & 15) != X86::RSP);
+        // mod 01 with a zero 8 bit displacement works for all bases including rbp and r13
+        byte((uint8_t) (0x44 | ((reg & 7) << 3)));
+        byte((uint8_t) (((index & 7) << 3) | (base & 7)));
+        byte(0);
+    }
+
+    void X86Assembler::push(X86::Register reg) {
+        rex(false, 0, 0, reg);
+        byte((uint8_t) (0x50 + (reg & 7)));
+    }
+
+    void X86Assembler::pop(X86::Register reg) {
+        rex(false, 0, 0, reg);
+        byte((uint8_t) (0x58 + (reg & 7)));
+    }
+
+    void X86Assembler::ret() {
+        byte(0xC3);
+    }
+
+    void X86Assembler::mov(X86::Register dst, X86::Register src) {
+        rex(true, src, 0, dst);
+        byte(0x89);
+        modRmRegister(src, dst);
+    }
+
+    void X86Assembler::load64(X86::Register dst, X86::Register base, int32_t displacement) {
+        rex(true, dst, 0, base);
+        byte(0x8B);
+        modRmMemory(dst, base, displacement);
+    }
+
+    void X86Assembler::load32(X86::Register dst, X86::Register base, int32_t displacement) {
+        rex(false, dst, 0, base);
+        byte(0x8B);
+        modRmMemory(dst, base, displacement);
+    }
+
+    void X86Assembler::store64(X86::Register base, int32_t displacement, X86::Register src) {
+        rex(true, src, 0, base);
+        byte(0x89);
+        modRmMemory(src, base, displacement);
+    }
+
+    void X86Assembler::loadIndexed(std::size_t size, X86::Register dst, X86::Register base, X86::Register index) {
+        switch (size) {
+            case 1:
+                rex(false, dst, index, base);
+                byte(0x0F);
+                byte(0xB6);
+                break;
+            case 2:
+                rex(false, dst, index, base);
+                byte(0x0F);
+                byte(0xB7);
+                break;
+            case 4:
+                rex(false, dst, index, base);
+                byte(0x8B);
+                break;
+            case 8:
+                rex(true, dst, index, base);
+                byte(0x8B);
+                break;
+            default:
+                assert(false);
+        }
+        modRmMemoryIndexed(dst, base, index);
+    }
+
+    void X86Assembler::movImmediate32(X86::Register dst, uint32_t value) {
+        rex(false, 0, 0, dst);
+        byte((uint8_t) (0xB8 + (dst & 7)));
+        int32(value);
+    }
+
+    void X86Assembler::movImmediate64(X86::Register dst, uint64_t value) {
+        rex(true, 0, 0, dst);
+        byte((uint8_t) (0xB8 + (dst & 7)));
+        int64(value);
+    }
+
+    void X86Assembler::lea(X86::Register dst, X86::Register base, int32_t displacement) {
+        rex(true, dst, 0, base);
+        byte(0x8D);
+        modRmMemory(dst, base, displacement);
+    }
+
+    void X86Assembler::alu(X86::AluOperation operation, bool wide, X86::Register dst, X86::Register src) {
+        rex(wide, src, 0, dst);
+        byte((uint8_t) operation);
+        modRmRegister(src, dst);
+    }
+
+    void X86Assembler::imul(bool wide, X86::Register dst, X86::Register src) {
+        rex(wide, dst, 0, src);
+        byte(0x0F);
+        byte(0xAF);
+        modRmRegister(dst, src);
+    }
+
+    void X86Assembler::addImmediate(X86::Register reg, int32_t value) {
+        rex(true, 0, 0, reg);
+        byte(0x81);
+        modRmRegister(0, reg);
+        int32((uint32_t) value);
+    }
+
+    void X86Assembler::subImmediate(X86::Register reg, int32_t value) {
+        rex(true, 0, 0, reg);
+        byte(0x81);
+        modRmRegister(5, reg);
+        int32((uint32_t) value);
+    }
+
+    void X86Assembler::increment(X86::Register reg) {
+        rex(true, 0, 0, reg);
+        byte(0xFF);
+        modRmRegister(0, reg);
+    }
+
+    void X86Assembler::addToMemory(X86::Register base, int32_t displacement, X86::Register src) {
+        rex(true, src, 0, base);
+        byte(0x01);
+        modRmMemory(src, base, displacement);
+    }
+
+    void X86Assembler::compareWithMemory(X86::Register reg, X86::Register base, int32_t displacement) {
+        rex(true, reg, 0, base);
+        byte(0x3B);
+        modRmMemory(reg, base, displacement);
+    }
+
+    void X86Assembler::testByte(X86::Register reg) {
+        // only the legacy byte registers are supported so we never need a REX prefix
+        assert(reg < X86::RSP);
+        byte(0x84);
+        modRmRegister(reg, reg);
+    }
+
+    void X86Assembler::setAndExtend(X86::Condition condition, X86::Register reg) {
+        assert(reg < X86::RSP);
+        byte(0x0F);
+        byte((uint8_t) (0x90 + condition));
+        modRmRegister(0, reg);
+        // movzx reg32, reg8
+        byte(0x0F);
+        byte(0xB6);
+        modRmRegister(reg, reg);
+    }
+
+    void X86Assembler::call(X86::Register reg) {
+        rex(false, 0, 0, reg);
+        byte(0xFF);
+        modRmRegister(2, reg);
+    }
+
+    void X86Assembler::jump(X86::Register reg) {
+        rex(false, 0, 0, reg);
+        byte(0xFF);
+        modRmRegister(4, reg);
+    }
+
+    std::size_t X86Assembler::jump() {
+        byte(0xE9);
+        std::size_t result = position();
+        int32(0);
+        return result;
+    }
+
+    std::size_t X86Assembler::jumpIf(X86::Condition condition) {
+        byte(0x0F);
+        byte((uint8_t) (0x80 + condition));
+        std::size_t result = position();
+        int32(0);
+        return result;
+    }
+
+    std::size_t X86Assembler::call() {
+        byte(0xE8);
+        std::size_t result = position();
+        int32(0);
+        return result;
+    }
+
+    void X86Assembler::patch(std::size_t displacementPosition, std::size_t target) {
+        int64_t displacement = (int64_t) target - (int64_t) (displacementPosition + 4);
+        uint32_t value = (uint32_t) (int32_t) displacement;
+        for (int i = 0; i < 4; i++) {
+            code_[displacementPosition + i] = (uint8_t) (value >> (i * 8));
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_X86ASSEMBLER_H
+#define WASMINT_X86ASSEMBLER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace wasmint {
+
+    namespace X86 {
+        enum Register {
+            RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+            R8, R9, R10, R11, R12, R13, R14, R15
+        };
+
+        enum Condition {
+            Overflow = 0x0, NotOverflow = 0x1,
+            Below = 0x2, AboveEqual = 0x3,
+            Equal = 0x4, NotEqual = 0x5,
+            BelowEqual = 0x6, Above = 0x7,
+            Less = 0xC, GreaterEqual = 0xD,
+            LessEqual = 0xE, Greater = 0xF
+        };
+
+        enum AluOperation {
+            Add = 0x01, Or = 0x09, And = 0x21, Sub = 0x29, Xor = 0x31, Cmp = 0x39, Test = 0x85
+        };
+    }
+
+    /**
+     * Emits x86-64 machine code into a byte buffer. Only the handful of instructions
+     * the native backend needs are supported. Memory operands always use a 32 bit
+     * displacement which keeps the encoding uniform for every base register.
+     */
+    class X86Assembler {
+
+        std::vector<uint8_t> code_;
+
+        void byte(uint8_t value) {
+            code_.push_back(value);
+        }
+
+        void int32(uint32_t value);
+        void int64(uint64_t value);
+
+        void rex(bool wide, unsigned reg, unsigned index, unsigned base);
+        void modRmRegister(unsigned reg, unsigned rm);
+        void modRmMemory(unsigned reg, unsigned base, int32_t displacement);
+        void modRmMemoryIndexed(unsigned reg, unsigned base, unsigned index);
+
+    public:
+        const std::vector<uint8_t>& code() const {
+            return code_;
+        }
+
+        std::size_t position() const {
+            return code_.size();
+        }
+
+        void push(X86::Register reg);
+        void pop(X86::Register reg);
+        void ret();
+
+        // mov dst, src (64 bit)
+        void mov(X86::Register dst, X86::Register src);
+        // mov dst, [base + displacement] with a 64 bit or zero extended 32 bit destination
+        void load64(X86::Register dst, X86::Register base, int32_t displacement);
+        void load32(X86::Register dst, X86::Register base, int32_t displacement);
+        // mov [base + displacement], src
+        void store64(X86::Register base, int32_t displacement, X86::Register src);
+        // zero extending load of size bytes from [base + index]
+        void loadIndexed(std::size_t size, X86::Register dst, X86::Register base, X86::Register index);
+        void movImmediate32(X86::Register dst, uint32_t value);
+        void movImmediate64(X86::Register dst, uint64_t value);
+        // lea dst, [base + displacement]
+        void lea(X86::Register dst, X86::Register base, int32_t displacement);
+
+        // <operation> dst, src with 32 or 64 bit operands
+        void alu(X86::AluOperation operation, bool wide, X86::Register dst, X86::Register src);
+        void imul(bool wide, X86::Register dst, X86::Register src);
+        void addImmediate(X86::Register reg, int32_t value);
+        void subImmediate(X86::Register reg, int32_t value);
+        void increment(X86::Register reg);
+        // add [base + displacement], src
+        void addToMemory(X86::Register base, int32_t displacement, X86::Register src);
+        // cmp reg, [base + displacement]
+        void compareWithMemory(X86::Register reg, X86::Register base, int32_t displacement);
+        // test al, al
+        void testByte(X86::Register reg);
+        // setcc on the low byte of reg followed by a zero extension to 32 bit
+        void setAndExtend(X86::Condition condition, X86::Register reg);
+
+        void call(X86::Register reg);
+        void jump(X86::Register reg);
+
+        // The following jumps return the position of their 32 bit displacement
+        // which has to be filled later on with patch().
+        std::size_t jump();
+        std::size_t jumpIf(X86::Condition condition);
+        std::size_t call();
+
+        void patch(std::size_t displacementPosition, std::size_t target);
+    };
+}
+
+#endif //WASMINT_X86ASSEMBLER_H
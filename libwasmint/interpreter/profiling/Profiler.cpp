@@ -0,0 +1,88 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "Profiler.h"
+
+namespace wasmint {
+
+    void Profiler::run() {
+        const bool nativeExecution = vm_.nativeExecution();
+        vm_.nativeExecution(false);
+        try {
+            while (!vm_.finished()) {
+                vm_.stepUntil(vm_.instructionCounter().toUint64() + interval_);
+                sample();
+            }
+        } catch (...) {
+            vm_.nativeExecution(nativeExecution);
+            throw;
+        }
+        vm_.nativeExecution(nativeExecution);
+    }
+
+    void Profiler::sample() {
+        const VMThread& thread = vm_.state().thread();
+        if (thread.finished() || thread.frameCount() == 0)
+            return;
+
+        std::string stack;
+        for (const FunctionFrame& frame : thread.frames()) {
+            if (!stack.empty())
+                stack += ';';
+            stack += frame.function().function().name();
+        }
+
+        const FunctionFrame& top = thread.frames().back();
+        functionSamples_[&top.function().function()]++;
+        const wasm_module::Instruction* instruction = top.function().jitCompiler().instructionAt(top.instructionPointer());
+        if (!instruction) {
+            // the return at the end of the function belongs to its body
+            instruction = top.function().function().mainInstruction();
+        }
+        instructionSamples_[instruction]++;
+        if (instructionFrames_) {
+            stack += ';';
+            stack += instruction->name();
+        }
+        foldedStacks_[stack]++;
+        sampleCount_++;
+    }
+
+    void Profiler::clear() {
+        sampleCount_ = 0;
+        foldedStacks_.clear();
+        functionSamples_.clear();
+        instructionSamples_.clear();
+    }
+
+    uint64_t Profiler::samples(const wasm_module::Function& function) const {
+        auto iter = functionSamples_.find(&function);
+        return iter == functionSamples_.end() ? 0 : iter->second;
+    }
+
+    uint64_t Profiler::samples(const wasm_module::Instruction& instruction) const {
+        auto iter = instructionSamples_.find(&instruction);
+        return iter == instructionSamples_.end() ? 0 : iter->second;
+    }
+
+    void Profiler::writeFoldedStacks(std::ostream& output) const {
+        for (const auto& entry : foldedStacks_) {
+            output << entry.first << " " << entry.second << "\n";
+        }
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_PROFILER_H
+#define WASMINT_PROFILER_H
+
+#include <interpreter/WasmintVM.h>
+#include <map>
+#include <ostream>
+
+namespace wasmint {
+
+    /**
+     * Sampling profiler that looks at the call stack of the VM every few instructions.
+     * The samples are attributed to the function on top of the stack and to the instruction
+     * whose bytecode contains the current instruction pointer. The call stacks can be written in
+     * the folded format that flamegraph.pl and similar tools consume.
+     *
+     * As the interval is measured in executed instructions and not in time, the profile shows
+     * where the instructions are spent and is the same in every run of a program.
+     */
+    class Profiler {
+
+        WasmintVM& vm_;
+        uint64_t interval_ = 1000;
+        bool instructionFrames_ = true;
+
+        uint64_t sampleCount_ = 0;
+        std::map<std::string, uint64_t> foldedStacks_;
+        std::map<const wasm_module::Function*, uint64_t> functionSamples_;
+        std::map<const wasm_module::Instruction*, uint64_t> instructionSamples_;
+
+    public:
+        Profiler(WasmintVM& vm) : vm_(vm) {
+        }
+
+        /**
+         * Number of instructions between two samples.
+         */
+        void interval(uint64_t instructions) {
+            if (instructions == 0)
+                throw std::domain_error("The sample interval can't be 0");
+            interval_ = instructions;
+        }
+
+        uint64_t interval() const {
+            return interval_;
+        }
+
+        /**
+         * If enabled, the folded stacks end with the name of the sampled instruction as an extra frame.
+         */
+        void instructionFrames(bool enabled) {
+            instructionFrames_ = enabled;
+        }
+
+        /**
+         * Runs the VM until its thread finished and takes a sample every interval() instructions.
+         * Native code only returns to the interpreter at calls, so it is disabled meanwhile to
+         * sample at the exact intervals.
+         */
+        void run();
+
+        /**
+         * Records the current call stack of the VM.
+         */
+        void sample();
+
+        void clear();
+
+        uint64_t sampleCount() const {
+            return sampleCount_;
+        }
+
+        /**
+         * Samples per call stack. The frames are separated by ';' from the outermost to the innermost.
+         */
+        const std::map<std::string, uint64_t>& foldedStacks() const {
+            return foldedStacks_;
+        }
+
+        /**
+         * Samples in which the function was on top of the call stack.
+         */
+        uint64_t samples(const wasm_module::Function& function) const;
+
+        /**
+         * Samples in which the instruction was about to be executed.
+         */
+        uint64_t samples(const wasm_module::Instruction& instruction) const;
+
+        const std::map<const wasm_module::Instruction*, uint64_t>& instructionSamples() const {
+            return instructionSamples_;
+        }
+
+        /**
+         * Writes one line per call stack with the stack and its number of samples.
+         */
+        void writeFoldedStacks(std::ostream& output) const;
+    };
+}
+
+#endif //WASMINT_PROFILER_H
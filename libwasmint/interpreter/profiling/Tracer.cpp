@@ -0,0 +1,110 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "Tracer.h"
+#include <Module.h>
+#include <iomanip>
+#include <stdexcept>
+
+namespace wasmint {
+
+    namespace {
+        void writeJsonString(std::ostream& output, const std::string& value) {
+            output << '"';
+            for (char c : value) {
+                if (c == '"' || c == '\\')
+                    output << '\\';
+                output << c;
+            }
+            output << '"';
+        }
+    }
+
+    Tracer::Tracer(std::size_t capacity, uint32_t threadId)
+            : capacity_(capacity), start_(std::chrono::steady_clock::now()), threadId_(threadId) {
+        if (capacity == 0)
+            throw std::domain_error("The trace buffer needs room for at least one event");
+    }
+
+    bool Tracer::matchesFilter(const wasm_module::Function& function) {
+        if (modules_.empty() && functions_.empty())
+            return true;
+
+        auto iter = matchesFilter_.find(&function);
+        if (iter != matchesFilter_.end())
+            return iter->second;
+
+        bool matches = modules_.count(function.module().name()) != 0 || functions_.count(function.name()) != 0;
+        matchesFilter_[&function] = matches;
+        return matches;
+    }
+
+    void Tracer::traceModule(const std::string& moduleName) {
+        modules_.insert(moduleName);
+        matchesFilter_.clear();
+    }
+
+    void Tracer::traceFunction(const std::string& functionName) {
+        functions_.insert(functionName);
+        matchesFilter_.clear();
+    }
+
+    void Tracer::sampleInterval(uint64_t calls) {
+        if (calls == 0)
+            throw std::domain_error("The sample interval can't be 0");
+        sampleInterval_ = calls;
+    }
+
+    void Tracer::clear() {
+        events_.clear();
+        nextEvent_ = 0;
+        wrapped_ = false;
+        matchingCalls_ = 0;
+        recordedCalls_.clear();
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    void Tracer::writeChromeTrace(std::ostream& output) const {
+        output << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+        std::size_t first = nextEvent_;
+        std::size_t depth = 0;
+        const char* separator = "\n";
+        for (std::size_t i = 0; i < eventCount(); i++) {
+            const Event& event = events_[(first + i) % events_.size()];
+            if (event.enter) {
+                depth++;
+            } else {
+                if (depth == 0)
+                    continue;
+                depth--;
+            }
+
+            output << separator << "{\"name\": ";
+            writeJsonString(output, event.function->name());
+            output << ", \"cat\": ";
+            writeJsonString(output, event.function->module().name());
+            // the timestamps are in microseconds
+            output << ", \"ph\": \"" << (event.enter ? 'B' : 'E') << "\", \"ts\": "
+                   << event.time / 1000 << "." << std::setw(3) << std::setfill('0') << event.time % 1000
+                   << std::setfill(' ') << ", \"pid\": 1, \"tid\": " << threadId_ << "}";
+            separator = ",\n";
+        }
+        output << "\n]}\n";
+    }
+}
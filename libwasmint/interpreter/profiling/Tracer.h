@@ -0,0 +1,140 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_TRACER_H
+#define WASMINT_TRACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Function.h>
+
+namespace wasmint {
+
+    /**
+     * Records when functions are entered and left into a ring buffer and writes them in the
+     * Chrome trace event format, which chrome://tracing and Perfetto can display. A tracer
+     * belongs to a single VM thread and is attached via WasmintVM::tracer().
+     *
+     * To keep the overhead low, the recorded functions can be restricted to modules and
+     * functions with given names and to every n-th call. Once the buffer is full, the oldest
+     * events are overwritten.
+     */
+    class Tracer {
+
+        struct Event {
+            // nanoseconds since the tracer was created or cleared
+            uint64_t time;
+            const wasm_module::Function* function;
+            bool enter;
+        };
+
+        // grows up to the capacity and then overwrites the oldest event at nextEvent_
+        std::vector<Event> events_;
+        std::size_t capacity_;
+        std::size_t nextEvent_ = 0;
+        bool wrapped_ = false;
+        std::chrono::steady_clock::time_point start_;
+        uint32_t threadId_;
+
+        std::set<std::string> modules_;
+        std::set<std::string> functions_;
+        std::unordered_map<const wasm_module::Function*, bool> matchesFilter_;
+        uint64_t sampleInterval_ = 1;
+        uint64_t matchingCalls_ = 0;
+
+        // for each active call if it was recorded, so the exit is recorded too
+        std::vector<bool> recordedCalls_;
+
+        bool matchesFilter(const wasm_module::Function& function);
+
+        void record(const wasm_module::Function* function, bool enter) {
+            uint64_t time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_).count();
+            if (events_.size() < capacity_) {
+                events_.push_back({time, function, enter});
+                return;
+            }
+            events_[nextEvent_] = {time, function, enter};
+            wrapped_ = true;
+            if (++nextEvent_ == capacity_)
+                nextEvent_ = 0;
+        }
+
+    public:
+        Tracer(std::size_t capacity = 1 << 20, uint32_t threadId = 1);
+
+        /**
+         * Only records functions of modules with the given name. Can be combined with traceFunction(),
+         * in which case functions that match either filter are recorded.
+         */
+        void traceModule(const std::string& moduleName);
+
+        /**
+         * Only records functions with the given name.
+         */
+        void traceFunction(const std::string& functionName);
+
+        /**
+         * Only records every n-th call of the functions that pass the filters.
+         */
+        void sampleInterval(uint64_t calls);
+
+        void enter(const wasm_module::Function& function) {
+            bool recorded = matchesFilter(function) && matchingCalls_++ % sampleInterval_ == 0;
+            recordedCalls_.push_back(recorded);
+            if (recorded)
+                record(&function, true);
+        }
+
+        void exit(const wasm_module::Function& function) {
+            // calls that started before the tracer was attached are unknown
+            if (recordedCalls_.empty())
+                return;
+            bool recorded = recordedCalls_.back();
+            recordedCalls_.pop_back();
+            if (recorded)
+                record(&function, false);
+        }
+
+        /**
+         * Removes all events and restarts the clock.
+         */
+        void clear();
+
+        std::size_t eventCount() const {
+            return events_.size();
+        }
+
+        bool overflowed() const {
+            return wrapped_;
+        }
+
+        /**
+         * Writes a JSON object with the events in the Chrome trace event format. If the buffer
+         * overflowed, the exits of calls whose entries were overwritten are omitted.
+         */
+        void writeChromeTrace(std::ostream& output) const;
+    };
+}
+
+#endif //WASMINT_TRACER_H
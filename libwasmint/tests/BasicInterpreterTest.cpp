@@ -78,4 +78,17 @@ int main() {
         thread.stepUntilFinished();
         assert(thread.gotTrap());
     }
+    // br_if only branches if its condition isn't zero
+    for (int32_t condition = 0; condition < 2; condition++) {
+        MachineState environment;
+
+        Module* module = ModuleParser::parse("module (func $main (block $b (br_if $b (i32.const "
+                                             + std::to_string(condition) + ")) (unreachable)))");
+
+        environment.useModule(*module, true);
+
+        InterpreterThread & thread = environment.createThread().startAtFunction(module->name(), "$main");
+        thread.stepUntilFinished();
+        assert(thread.gotTrap() == (condition == 0));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+int main() {
+    WasmintVM vm;
+
+    Module* module = ModuleParser::parse(
+            "module "
+            "(memory 1024)"
+            "(func $sub (param $a i32) (param $b i32) (result i32) (i32.sub (get_local $a) (get_local $b)))"
+            "(func $scale (param $a f64) (param $b i64) (result f64) (f64.mul (get_local $a) (f64.convert_s/i64 (get_local $b))))"
+            "(func $store (param $a i32) (i32.store (i32.const 0) (get_local $a)))"
+            "(func $load (result i32) (i32.load (i32.const 0)))"
+            "(func $fail (unreachable))");
+    vm.loadModule(*module, true);
+
+    FunctionHandle sub = vm.functionHandle(*module->function("$sub"));
+    FunctionHandle scale = vm.functionHandle(module->name(), "$scale");
+
+    for (int32_t i = 0; i < 1000; i++) {
+        assert(vm.call<int32_t>(sub, i, 3) == i - 3);
+    }
+    assert(vm.call<double>(scale, 1.5, (int64_t) 4) == 6.0);
+
+    // the heap is kept between calls
+    vm.call<void>(vm.functionHandle(*module->function("$store")), 42);
+    assert(vm.call<int32_t>(vm.functionHandle(*module->function("$load"))) == 42);
+
+    bool trapped = false;
+    try {
+        vm.call<void>(vm.functionHandle(*module->function("$fail")));
+    } catch (const CallTrapped& ex) {
+        trapped = true;
+    }
+    assert(trapped);
+
+    // the thread can be used again after a trap
+    assert(vm.call<int32_t>(sub, 10, 20) == -10);
+
+    // a call replaces the recorded execution, so rewinding it afterwards can't restore a stale heap
+    for (bool dirtyPageTracking : {false, true}) {
+        if (dirtyPageTracking && !DirtyPageTracker::supported())
+            continue;
+        WasmintVM historyVM;
+        historyVM.history().dirtyPageTracking(dirtyPageTracking);
+        historyVM.loadModule(*module, false);
+        historyVM.startAtFunction(*module->function("$store"), {Variable::createInt32(5)}, true);
+        historyVM.stepUntilFinished();
+        historyVM.simulateTo(0);
+        historyVM.stepUntilFinished();
+
+        historyVM.call<void>(historyVM.functionHandle(*module->function("$store")), 77);
+        assert(!historyVM.history().enabled());
+        assert(historyVM.history().numberOfCheckpoints() == 0);
+
+        bool rewound = true;
+        try {
+            historyVM.simulateTo(0);
+        } catch (const HistoryNotEnabled& ex) {
+            rewound = false;
+        }
+        assert(!rewound);
+        assert(historyVM.call<int32_t>(historyVM.functionHandle(*module->function("$load"))) == 77);
+    }
+
+    bool invalidParameters = false;
+    try {
+        vm.call<int64_t>(sub, 10, 20);
+    } catch (const InvalidCallParameters& ex) {
+        invalidParameters = true;
+    }
+    assert(invalidParameters);
+}
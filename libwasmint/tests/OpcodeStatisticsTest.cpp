@@ -0,0 +1,105 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <cstdint>
+#include <sstream>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/OpcodeStatistics.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+const std::string source = "module "
+        "(func $square (param $a i32) (result i32) (i32.mul (get_local $a) (get_local $a))) "
+        "(func $main (result i32) (local $i i32) (local $sum i32) "
+        "(loop $exit $cont "
+        "(set_local $sum (i32.add (get_local $sum) (call $square (get_local $i)))) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100)))) "
+        "(get_local $sum))";
+
+int main() {
+    Module* module = ModuleParser::parse(source);
+    const Function& main = *module->function("$main");
+    const Function& square = *module->function("$square");
+
+    // the output is only useful if every opcode has its own name
+    assert(ByteOpcodes::name(ByteOpcodes::Drop) == "Drop");
+    assert(ByteOpcodes::name(ByteOpcodes::Breakpoint) == "Breakpoint");
+    {
+        OpcodeStatistics statistics;
+        statistics.count(ByteOpcodes::I32Add, main);
+        statistics.count(ByteOpcodes::I32Add, main);
+        // breakpoints are counted as the opcode they replace
+        statistics.count(ByteOpcodes::Breakpoint, main);
+        statistics.count(ByteOpcodes::I32Mul, square);
+        assert(statistics.totalCount() == 3);
+        assert(statistics.opcodeCount(ByteOpcodes::I32Add) == 2);
+        assert(statistics.pairCount(ByteOpcodes::I32Add, ByteOpcodes::I32Add) == 1);
+        assert(statistics.pairCount(ByteOpcodes::I32Add, ByteOpcodes::I32Mul) == 1);
+        assert(statistics.functionCount(main) == 2);
+        assert(statistics.functionCount(square) == 1);
+
+        std::stringstream csv;
+        statistics.writeCsv(csv);
+        assert(csv.str() == "kind,name,count\n"
+                "opcode,I32Add,2\n"
+                "opcode,I32Mul,1\n"
+                "pair,I32Add>I32Add,1\n"
+                "pair,I32Add>I32Mul,1\n"
+                "function,unnamedModule.$main,2\n"
+                "function,unnamedModule.$square,1\n");
+
+        std::stringstream json;
+        statistics.writeJson(json);
+        assert(json.str() == "{\n"
+                "  \"opcodes\": {\n    \"I32Add\": 2,\n    \"I32Mul\": 1\n  },\n"
+                "  \"pairs\": {\n    \"I32Add>I32Add\": 1,\n    \"I32Add>I32Mul\": 1\n  },\n"
+                "  \"functions\": {\n    \"unnamedModule.$main\": 2,\n    \"unnamedModule.$square\": 1\n  }\n"
+                "}\n");
+
+        statistics.clear();
+        assert(statistics.totalCount() == 0);
+    }
+
+#ifdef WASMINT_OPCODE_STATS
+    {
+        // the interpreter counts every opcode it executes
+        WasmintVM vm;
+        vm.nativeExecution(false);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(main);
+        vm.stepUntilFinished();
+        const OpcodeStatistics& statistics = vm.opcodeStatistics();
+        assert(statistics.totalCount() == vm.instructionCounter().toUint64());
+        assert(statistics.functionCount(main) + statistics.functionCount(square) == statistics.totalCount());
+        assert(statistics.opcodeCount(ByteOpcodes::I32Mul) == 100);
+        assert(statistics.functionCount(square) > 100);
+
+        // replaying the history doesn't count the instructions again
+        const uint64_t total = statistics.totalCount();
+        vm.stepBack();
+        vm.simulateTo(vm.instructionCounter().toUint64() / 2);
+        assert(statistics.totalCount() == total);
+    }
+#endif
+}
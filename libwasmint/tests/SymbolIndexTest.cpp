@@ -0,0 +1,56 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+int main() {
+    WasmintVM vm;
+
+    Module* first = ModuleParser::parse("module (func $value (result i32) (i32.const 1)) (export \"value\" $value)", "first");
+    Module* second = ModuleParser::parse("module (func $other (result i32) (i32.const 3))"
+                                                 "(func $value (result i32) (i32.add (call $other) (i32.const 2)))"
+                                                 "(export \"value\" $value)", "second");
+    vm.loadModule(*first, true);
+    vm.loadModule(*second, true);
+
+    assert(vm.getIndex("first", "$value") == 0);
+    assert(vm.getIndex("second", "$other") == 1);
+    assert(vm.getIndex("second", "$value") == 2);
+
+    std::size_t index;
+    assert(!vm.findIndex("first", "$other", index));
+    assert(!vm.findIndex("third", "$value", index));
+
+    assert(vm.functionsWithName("$value").size() == 2);
+    assert(vm.functionsWithName("$main").empty());
+
+    const std::vector<FunctionHandle>& exports = vm.exportedFunctions("value");
+    assert(exports.size() == 2);
+    assert(&exports[0].function() == first->function("$value"));
+    assert(&exports[1].function() == second->function("$value"));
+
+    assert(vm.call<int32_t>(exports[0]) == 1);
+    assert(vm.call<int32_t>(exports[1]) == 5);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_TESTHELPERS_H
+#define WASMINT_TESTHELPERS_H
+
+#include <cstdint>
+#include <string>
+#include <Module.h>
+#include <interpreter/debugging/BreakpointHandler.h>
+#include <interpreter/debugging/WatchpointHandler.h>
+
+namespace wasmint {
+
+    /**
+     * A module named "host" with the native function "double", which returns twice its i32 parameter.
+     */
+    inline wasm_module::Module* createDoublingHostModule() {
+        wasm_module::Module* module = new wasm_module::Module();
+        module->context().name("host");
+        module->addTypedFunction<int32_t(int32_t)>("double", [](int32_t value) {
+            return value * 2;
+        });
+        return module;
+    }
+
+    /**
+     * The first instruction with the given name in a depth-first search, or nullptr.
+     */
+    inline const wasm_module::Instruction* findInstruction(const wasm_module::Instruction* instruction,
+                                                           const std::string& name) {
+        if (instruction->name() == name)
+            return instruction;
+        for (const wasm_module::Instruction* child : instruction->children()) {
+            if (const wasm_module::Instruction* result = findInstruction(child, name))
+                return result;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Counts the reached breakpoints and watchpoints and remembers the value of the last breakpoint.
+     */
+    class CountingHandler : public BreakpointHandler, public WatchpointHandler {
+    public:
+        std::size_t hits = 0;
+        std::string lastValue;
+
+        virtual void reachedBreakpoint(const Breakpoint&, BreakpointEnvironment& environment) override {
+            hits++;
+            lastValue = environment.returnValue();
+        }
+
+        virtual void reachedWatchpoint(const Watchpoint&, const Heap&, const Interval&) override {
+            hits++;
+        }
+    };
+}
+
+#endif //WASMINT_TESTHELPERS_H
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <cstdint>
+#include <sstream>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <tests/TestHelpers.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// $main calls $step 10 times directly and $seven 10 times via the table, both call host.double
+// and $main grows the memory once
+const std::string source = "module (memory 1 4) "
+        "(import $double \"host\" \"double\" (param i32) (result i32)) "
+        "(type $sevenType (func (result i32))) "
+        "(func $step (param $a i32) (result i32) (call_import $double (get_local $a))) "
+        "(func $seven (type $sevenType) (result i32) (call_import $double (i32.const 7))) "
+        "(func $main (result i32) (local $i i32) (local $sum i32) "
+        "(grow_memory (i32.const 1)) "
+        "(loop $exit $cont "
+        "(set_local $sum (i32.add (get_local $sum) (call $step (get_local $i)))) "
+        "(set_local $sum (i32.add (get_local $sum) (call_indirect $sevenType (i32.const 0)))) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 10)))) "
+        "(get_local $sum)) "
+        "(table $seven)";
+
+int main() {
+    WasmintVM vm;
+    // the heap is created from the first loaded module
+    vm.loadModuleFromData(source);
+    vm.loadModule(*createDoublingHostModule(), true);
+    vm.startAtFunction(*vm.modules().front()->function("$main"), true);
+    vm.stepUntilFinished();
+    assert(!vm.gotTrap());
+    assert(vm.state().thread().result().int32() == 230);
+
+    VMStats stats = vm.stats();
+    assert(stats.instructions == vm.instructionCounter().toUint64());
+    assert(stats.directCalls == 10);
+    assert(stats.indirectCalls == 10);
+    assert(stats.nativeCalls == 20);
+    // $main -> $step
+    assert(stats.maxCallDepth == 2);
+    assert(stats.heapGrowths == 1);
+    assert(stats.heapSize == 2 * 65536);
+    assert(stats.historyBytes > 0);
+    assert(stats.parseTime.count() > 0);
+    assert(stats.compileTime.count() > 0);
+
+    // restoring a state replays the instructions since the last checkpoint, which isn't counted again
+    for (int i = 0; i < 5; i++) {
+        vm.stepBack();
+    }
+    vm.simulateTo(stats.instructions / 2);
+    assert(!vm.reverseContinue());
+    VMStats rewoundStats = vm.stats();
+    assert(rewoundStats.directCalls == 10);
+    assert(rewoundStats.indirectCalls == 10);
+    assert(rewoundStats.nativeCalls == 20);
+    assert(rewoundStats.maxCallDepth == 2);
+    assert(rewoundStats.heapGrowths == 1);
+
+    std::stringstream output;
+    stats.print(output);
+    assert(output.str().find("indirect calls: 10\n") != std::string::npos);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <tests/TestHelpers.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+const std::string source = "module (func $main (result i32) (local $i i32) "
+        "(loop $exit $cont "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 5000)))) "
+        "(get_local $i))";
+
+InstructionCounter runWithoutBreakpoints() {
+    WasmintVM vm;
+    vm.nativeExecution(false);
+    Module* module = ModuleParser::parse(source);
+    vm.loadModule(*module, true);
+    vm.startAtFunction(*module->functions().front());
+    vm.stepUntilFinished();
+    return vm.instructionCounter();
+}
+
+int main() {
+    const InstructionCounter expectedCounter = runWithoutBreakpoints();
+
+    for (bool native : {false, true}) {
+        // stopping at the breakpoint neither executes nor skips an instruction
+        CountingHandler handler;
+        WasmintVM vm;
+        vm.nativeExecution(native);
+        vm.tieringPolicy(TieringPolicy::eager());
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.addBreakpoint(findInstruction(module->functions().front()->mainInstruction(), "i32.add"), &handler);
+
+        while (!vm.finished()) {
+            vm.stepUntilFinished(true);
+        }
+        assert(handler.hits == 5000);
+        assert(handler.lastValue == "5000 (5000u)");
+        assert(vm.instructionCounter() == expectedCounter);
+        assert(vm.state().thread().result().int32() == 5000);
+    }
+    {
+        // without stopping the breakpoints run like the original code
+        CountingHandler handler;
+        WasmintVM vm;
+        vm.tieringPolicy(TieringPolicy::eager());
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.addBreakpoint(findInstruction(module->functions().front()->mainInstruction(), "i32.add"), &handler);
+        vm.stepUntilFinished(false);
+        assert(handler.hits == 0);
+        assert(vm.instructionCounter() == expectedCounter);
+        assert(vm.state().thread().result().int32() == 5000);
+    }
+    {
+        // going back before a breakpoint stops at it again
+        CountingHandler handler;
+        WasmintVM vm;
+        vm.nativeExecution(false);
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.addBreakpoint(findInstruction(module->functions().front()->mainInstruction(), "i32.add"), &handler);
+        vm.stepUntilFinished(true);
+        assert(handler.hits == 1);
+        InstructionCounter breakpointCounter = vm.instructionCounter();
+        vm.stepBack();
+        vm.stepUntilFinished(true);
+        assert(handler.hits == 2);
+        assert(vm.instructionCounter() == breakpointCounter);
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <tests/TestHelpers.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// stores i at (i * 4) & 1023, so address 400 is written for i = 100, 356, 612 and 868
+const std::string source = "module (memory 1 1) (func $main (local $i i32) "
+        "(loop $exit $cont "
+        "(i32.store (i32.and (i32.mul (get_local $i) (i32.const 4)) (i32.const 1023)) (get_local $i)) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 1000)))))";
+
+void testReverseContinue(bool native, bool breakpoint) {
+    CountingHandler handler;
+    WasmintVM vm;
+    vm.nativeExecution(native);
+    vm.tieringPolicy(TieringPolicy::eager());
+    Module* module = ModuleParser::parse(source);
+    vm.loadModule(*module, true);
+    vm.startAtFunction(*module->functions().front(), true);
+    if (breakpoint)
+        vm.addBreakpoint(findInstruction(module->functions().front()->mainInstruction(), "i32.add"), &handler);
+    else
+        vm.addWatchpoint(400, 4, &handler);
+
+    std::vector<InstructionCounter> stops;
+    while (true) {
+        vm.stepUntilFinished(true);
+        if (vm.finished())
+            break;
+        stops.push_back(vm.instructionCounter());
+    }
+    assert(stops.size() == (breakpoint ? 1000 : 4));
+    assert(handler.hits == stops.size());
+    const InstructionCounter finalCounter = vm.instructionCounter();
+
+    // going back visits the same stops in reverse order without calling the handlers
+    for (auto iter = stops.rbegin(); iter != stops.rend(); ++iter) {
+        assert(vm.reverseContinue());
+        assert(vm.instructionCounter() == *iter);
+    }
+    assert(!vm.reverseContinue());
+    assert(vm.instructionCounter() == stops.front());
+    assert(handler.hits == stops.size());
+
+    // continuing from there passes the stop instead of stopping at it again
+    vm.stepUntilFinished(true);
+    assert(vm.instructionCounter() == stops[1]);
+    assert(handler.hits == stops.size() + 1);
+
+    while (!vm.finished())
+        vm.stepUntilFinished(true);
+    assert(vm.instructionCounter() == finalCounter);
+    assert(handler.hits == 2 * stops.size() - 1);
+}
+
+int main() {
+    for (bool native : {false, true}) {
+        testReverseContinue(native, true);
+        testReverseContinue(native, false);
+    }
+}
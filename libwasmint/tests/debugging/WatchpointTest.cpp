@@ -0,0 +1,119 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <cstring>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/debugging/WatchpointHandler.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+uint32_t watchedValue(const Heap& heap) {
+    std::vector<uint8_t> bytes = heap.getBytes(400, 4);
+    uint32_t result;
+    std::memcpy(&result, bytes.data(), sizeof(result));
+    return result;
+}
+
+class CountingWatchpointHandler : public WatchpointHandler {
+public:
+    std::size_t hits = 0;
+    uint32_t oldValue = 0;
+
+    virtual void reachedWatchpoint(const Watchpoint&, const Heap& heap, const Interval&) {
+        hits++;
+        oldValue = watchedValue(heap);
+    }
+};
+
+// stores i at (i * 4) & 1023, so address 400 is written for i = 100, 356, 612 and 868
+const std::string source = "module (memory 1 1) (func $main (local $i i32) "
+        "(loop $exit $cont "
+        "(i32.store (i32.and (i32.mul (get_local $i) (i32.const 4)) (i32.const 1023)) (get_local $i)) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 1000)))))";
+
+int main() {
+    {
+        WatchpointTable table;
+        table.add(Watchpoint(Interval::withEnd(100, 130)));
+        assert(table.watched(Interval::withEnd(128, 136)));
+        assert(table.watched(Interval::withEnd(60, 68)));
+        assert(!table.watched(Interval::withEnd(0, 8)));
+        assert(!table.watched(Interval::withEnd(192, 200)));
+        assert(!table.watched(Interval::withEnd(100000, 100008)));
+        assert(table.remove(Interval::withEnd(100, 130)));
+        assert(!table.watched(Interval::withEnd(128, 136)));
+        assert(table.empty());
+    }
+
+    InstructionCounter expectedCounter;
+    for (bool native : {false, true}) {
+        CountingWatchpointHandler handler;
+        WasmintVM vm;
+        vm.nativeExecution(native);
+        vm.tieringPolicy(TieringPolicy::eager());
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.addWatchpoint(400, 4, &handler);
+        // stores next to the watched range don't stop
+        vm.addWatchpoint(1024, 4);
+
+        std::vector<uint32_t> values;
+        while (true) {
+            vm.stepUntilFinished(true);
+            if (vm.finished())
+                break;
+            values.push_back(watchedValue(vm.heap()));
+        }
+        assert(handler.hits == 4);
+        assert((values == std::vector<uint32_t>{100, 356, 612, 868}));
+        assert(handler.oldValue == 612);
+
+        if (native)
+            assert(vm.instructionCounter() == expectedCounter);
+        expectedCounter = vm.instructionCounter();
+    }
+    {
+        // the history still records the stores to the watched range
+        CountingWatchpointHandler handler;
+        WasmintVM vm;
+        vm.nativeExecution(false);
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.addWatchpoint(400, 4, &handler);
+
+        vm.stepUntilFinished(true);
+        vm.stepUntilFinished(true);
+        assert(watchedValue(vm.heap()) == 356);
+        vm.stepBack();
+        assert(watchedValue(vm.heap()) == 100);
+
+        assert(vm.removeWatchpoint(400, 4));
+        assert(vm.heap().observerCount() == 1);
+        vm.stepUntilFinished(true);
+        assert(vm.finished());
+        assert(handler.hits == 2);
+    }
+}
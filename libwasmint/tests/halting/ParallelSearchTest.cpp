@@ -0,0 +1,63 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/halting/HaltingProblemDetector.h>
+#include <cassert>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// runs the program for the given number of instructions and searches the history with the given threads
+bool isLooping(const std::string& source, std::size_t steps, unsigned threads) {
+    WasmintVM vm;
+    Module* module = ModuleParser::parse(source);
+    vm.loadModule(*module, true);
+    vm.history().automaticCheckpoints(50, 256 * 1024 * 1024);
+    vm.startAtFunction(*module->function("$main"));
+    for (std::size_t i = 0; i < steps; i++)
+        vm.step();
+
+    VMState before = vm.state();
+    HaltingProblemDetector detector(vm);
+    detector.workerThreads(threads);
+    bool result = detector.isLooping();
+    assert(vm.state() == before);
+    return result;
+}
+
+int main() {
+    // the loop only repeats after the counter in memory wrapped around
+    const std::string looping = "module (memory 1 1) (func $main (local $i i32) "
+            "(loop $exit $cont (i32.store (i32.const 8) (i32.and (i32.add (i32.load (i32.const 8)) (i32.const 1)) (i32.const 63))) "
+            "(br $cont)))";
+    const std::string halting = "module (memory 1 1) (func $main (local $i i32) "
+            "(loop $exit $cont (i32.store (i32.const 8) (get_local $i)) "
+            "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+            "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100000)))))";
+
+    for (unsigned threads : {1u, 2u, 8u}) {
+        assert(isLooping(looping, 5000, threads));
+        assert(!isLooping(halting, 5000, threads));
+        // the loop wasn't completed once yet
+        assert(!isLooping(looping, 100, threads));
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/halting/HaltingProblemDetector.h>
+#include <cassert>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// the incremental hash has to match the hash computed from scratch
+void assertHashIsCurrent(const Heap& heap) {
+    Heap copy = heap;
+    copy.hashing(false);
+    assert(heap.hash() == copy.hash());
+}
+
+int main() {
+    {
+        Heap heap(1000);
+        Heap other(1000);
+        heap.hashing(true);
+        assert(heap.hash() == other.hash());
+
+        heap.set<uint32_t>(3, 0xdeadbeef);
+        heap.set<uint64_t>(100, 42);
+        heap.setByte(999, 7);
+        heap.setBytes(500, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+        assertHashIsCurrent(heap);
+        assert(heap.hash() != other.hash());
+
+        // equal content means equal hashes no matter how it was written
+        other.setBytes(3, {0xef, 0xbe, 0xad, 0xde});
+        other.set<uint8_t>(100, 42);
+        other.set<uint8_t>(999, 7);
+        other.setBytes(500, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+        assert(heap == other);
+        assert(heap.hash() == other.hash());
+
+        // the same values at other positions give a different hash
+        heap.set<uint64_t>(100, 0);
+        heap.set<uint64_t>(108, 42);
+        assertHashIsCurrent(heap);
+        assert(heap.hash() != other.hash());
+        heap.set<uint64_t>(108, 0);
+        heap.set<uint64_t>(100, 42);
+        assert(heap.hash() == other.hash());
+
+        // shrinking cuts through the last word
+        assert(heap.shrink(3));
+        assertHashIsCurrent(heap);
+        assert(heap.grow(3));
+        assertHashIsCurrent(heap);
+        assert(heap.hash() != other.hash());
+        heap.setByte(999, 7);
+        assert(heap.hash() == other.hash());
+
+        assert(heap.resize(501));
+        assertHashIsCurrent(heap);
+        assert(heap.resize(4000));
+        assertHashIsCurrent(heap);
+
+        heap = other;
+        assert(heap.hashing());
+        assert(heap.hash() == other.hash());
+    }
+    {
+        // the detector finds the repeated state via the hash and confirms it
+        WasmintVM vm;
+        Module* module = ModuleParser::parse("module (memory 1 1) (func $main (local $i i32) "
+                                                     "(loop $exit $cont (i32.store (i32.const 8) (get_local $i)) "
+                                                     "(set_local $i (i32.and (i32.add (get_local $i) (i32.const 1)) (i32.const 7))) "
+                                                     "(br $cont)))");
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->function("$main"));
+
+        HaltingProblemDetector detector(vm);
+        detector.hashInterval(4);
+        for (int i = 0; i < 1000; i++)
+            detector.step();
+        assert(vm.heap().hashing());
+        assertHashIsCurrent(vm.heap());
+
+        VMState before = vm.state();
+        assert(detector.isLooping());
+        assert(vm.state() == before);
+    }
+    {
+        // a program that halts isn't looping
+        WasmintVM vm;
+        Module* module = ModuleParser::parse("module (memory 1 1) (func $main (local $i i32) "
+                                                     "(loop $exit $cont (i32.store (i32.const 8) (get_local $i)) "
+                                                     "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                                                     "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100000)))))");
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->function("$main"));
+
+        HaltingProblemDetector detector(vm);
+        detector.hashInterval(4);
+        for (int i = 0; i < 1000; i++)
+            detector.step();
+        assert(!detector.isLooping());
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <interpreter/heap/Heap.h>
+#include <interpreter/heap/HeapImage.h>
+#include <interpreter/WasmintVM.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <cassert>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+int main() {
+    {
+        // heaps created from an image start with its content and don't modify it
+        Heap heap(70000);
+        heap.set<uint32_t>(4, 1234);
+        heap.set<uint32_t>(69990, 5678);
+        HeapImage image(heap);
+        assert(image.size() == heap.size());
+
+        Heap first(image);
+        assert(first == heap);
+        assert(first.set<uint32_t>(4, 1));
+        assert(first != heap);
+
+        Heap second(image);
+        assert(second == heap);
+
+        // growing copies the mapped content
+        assert(second.grow(100));
+        assert(second.size() == 70100);
+        assert(second.equalRange(heap, 0, heap.size()));
+        uint32_t value;
+        assert(second.get<uint32_t>(70000, &value) && value == 0);
+
+        first.useImage(image);
+        assert(first == heap);
+    }
+    {
+        // a VM can be reset to an initialized heap without running the initialization again
+        WasmintVM vm;
+        Module* module = ModuleParser::parse("module (memory 1 1) "
+            "(export \"init\" $init) (export \"next\" $next) "
+            "(func $init (i32.store (i32.const 8) (i32.const 100))) "
+            "(func $next (result i32) "
+                "(i32.store (i32.const 8) (i32.add (i32.load (i32.const 8)) (i32.const 1))) "
+                "(i32.load (i32.const 8)))");
+        vm.loadModule(*module, true);
+        vm.call<void>(vm.exportedFunctions("init").front());
+        HeapImage image(vm.heap());
+
+        const FunctionHandle& next = vm.exportedFunctions("next").front();
+        for (int i = 0; i < 3; i++) {
+            vm.instantiate(image);
+            assert(vm.call<int32_t>(next) == 101);
+            assert(vm.call<int32_t>(next) == 102);
+        }
+    }
+}
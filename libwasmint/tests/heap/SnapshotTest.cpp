@@ -0,0 +1,133 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <memory>
+#include <interpreter/heap/Heap.h>
+#include <interpreter/heap/HeapSnapshot.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/VMSnapshot.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <cassert>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+int main() {
+    const std::size_t chunk = HeapSnapshot::chunkSize;
+    {
+        // only modified chunks are copied
+        Heap heap(chunk * 100);
+        heap.set<uint32_t>(0, 1);
+        Heap original = heap;
+
+        HeapSnapshot snapshot(heap);
+        assert(snapshot == heap);
+        assert(snapshot.savedChunks() == 0);
+
+        heap.set<uint32_t>(0, 2);
+        heap.set<uint32_t>(4, 3);
+        heap.set<uint32_t>(chunk * 50 + 8, 4);
+        assert(snapshot.savedChunks() == 2);
+        assert(snapshot != heap);
+        assert(snapshot == original);
+        assert(snapshot.equalRange(heap, chunk, chunk * 50));
+        assert(!snapshot.equalRange(heap, chunk, chunk * 51));
+
+        snapshot.restore(heap);
+        assert(heap == original);
+    }
+    {
+        // older snapshots share chunks with newer ones and take them over when those are destroyed
+        Heap heap(chunk * 10);
+        HeapSnapshot first(heap);
+        Heap firstState = heap;
+
+        heap.set<uint8_t>(10, 1);
+        std::unique_ptr<HeapSnapshot> second(new HeapSnapshot(heap));
+        Heap secondState = heap;
+
+        heap.set<uint8_t>(chunk * 3, 2);
+        heap.set<uint8_t>(11, 3);
+        assert(first.savedChunks() == 1);
+        assert(second->savedChunks() == 2);
+        assert(first == firstState);
+        assert(*second == secondState);
+
+        second.reset();
+        assert(first.savedChunks() == 2);
+        assert(first == firstState);
+
+        first.restore(heap);
+        assert(heap == firstState);
+    }
+    {
+        // shrinking, growing and assigning the heap are copied too
+        Heap heap(chunk * 4 + 10);
+        heap.set<uint8_t>(chunk * 4 + 5, 7);
+        Heap original = heap;
+        HeapSnapshot snapshot(heap);
+
+        assert(heap.shrink(chunk * 2));
+        assert(heap.grow(chunk * 3));
+        heap = Heap(5);
+        assert(snapshot == original);
+
+        Heap other;
+        snapshot.restore(other);
+        assert(other == original);
+        snapshot.restore(heap);
+        assert(heap == original);
+    }
+    {
+        // snapshots stay valid if the heap is destroyed
+        std::unique_ptr<Heap> heap(new Heap(chunk * 3));
+        heap->set<uint32_t>(chunk, 42);
+        Heap original = *heap;
+        HeapSnapshot snapshot(*heap);
+        heap->set<uint32_t>(chunk, 43);
+        heap.reset();
+        assert(snapshot == original);
+    }
+    {
+        // the state of a VM can be restored from a snapshot
+        WasmintVM vm;
+        Module* module = ModuleParser::parse("module (memory 1 1) "
+            "(func $main (local $i i32) "
+                "(loop $exit $cont "
+                    "(i32.store (i32.mul (get_local $i) (i32.const 4)) (get_local $i)) "
+                    "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                    "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100))))))");
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->function("$main"), false);
+
+        for (int i = 0; i < 200; i++)
+            vm.step();
+        VMState copy = vm.state();
+        VMSnapshot snapshot(vm.state());
+        assert(snapshot == vm.state());
+
+        vm.stepUntilFinished();
+        assert(snapshot != vm.state());
+        assert(snapshot.heap().savedChunks() <= 1);
+
+        snapshot.restore(vm.state());
+        assert(snapshot == vm.state());
+        assert(copy == vm.state());
+    }
+}
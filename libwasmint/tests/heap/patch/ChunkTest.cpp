@@ -0,0 +1,73 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <cassert>
+#include <interpreter/heap/patch/HeapPatch.h>
+
+using namespace wasmint;
+
+class DummyObserver : public HeapObserver {
+public:
+    HeapPatch* patch;
+    virtual void preChanged(const Heap& heap, const Interval& changedInterval) {
+        patch->preHeapChanged(heap, changedInterval);
+    }
+
+};
+
+DummyObserver observer;
+
+int main() {
+    Heap heap;
+    heap.resize(100);
+    heap.set<uint64_t>(15, 13424556);
+    Heap heapBackup = heap;
+
+    HeapPatch heapPatch1(heap, 16);
+    observer.patch = &heapPatch1;
+    heap.attachObserver(observer);
+
+    // crosses the border between the chunks 0 and 1
+    heap.set<uint64_t>(12, 0xFFFFFFFFFFFFFFFF);
+    // the last chunk is smaller than the others
+    heap.set<uint32_t>(96, 77);
+    assert(heapPatch1.modifiedChunks() == std::vector<std::size_t>({0, 1, 6}));
+
+    Heap intermediateHeap = heap;
+    HeapPatch heapPatch2(heap, 16);
+    observer.patch = &heapPatch2;
+
+    heap.set<uint64_t>(4, 5);
+    heap.set<uint64_t>(40, 6);
+    heap.set<uint32_t>(96, 7);
+    assert(heapPatch2.modifiedChunks() == std::vector<std::size_t>({0, 2, 6}));
+
+    Heap endHeap = heap;
+    heapPatch2.applyPatch(heap);
+    assert(heap == intermediateHeap);
+    heapPatch1.applyPatch(heap);
+    assert(heap == heapBackup);
+
+    heap.setBytes(0, endHeap.getBytes(0, endHeap.size()));
+    assert(heap == endHeap);
+
+    heapPatch1.merge(heapPatch2);
+    assert(heapPatch1.modifiedChunks() == std::vector<std::size_t>({0, 1, 2, 6}));
+    heapPatch1.applyPatch(heap);
+    assert(heap == heapBackup);
+}
@@ -25,6 +25,7 @@
 #include <assert.h>
 #include <interpreter/WasmintVM.h>
 #include <iostream>
+#include <vector>
 
 using namespace wasm_module;
 using namespace wasm_module::sexpr;
@@ -55,5 +56,39 @@ int main() {
         }
         assert(vm.gotTrap());
     }
+    {
+        // shift counts are taken modulo 32
+        const std::vector<std::pair<std::string, int32_t>> shifts = {
+                {"(i32.shl (i32.const 1) (i32.const 32))", 1},
+                {"(i32.shl (i32.const 1) (i32.const 33))", 2},
+                {"(i32.shr_u (i32.const 256) (i32.const 4))", 16},
+                {"(i32.shr_u (i32.const 256) (i32.const 36))", 16},
+                {"(i32.shr_u (i32.const -2147483648) (i32.const 63))", 1},
+        };
+        for (const auto& shift : shifts) {
+            WasmintVM vm;
+
+            Module* module = ModuleParser::parse("module (func $main (result i32) " + shift.first + ")");
+            vm.loadModule(*module, true);
+            vm.startAtFunction(*module->functions().front());
+            vm.stepUntilFinished();
+            assert(!vm.gotTrap());
+            assert(vm.state().thread().result().int32() == shift.second);
+        }
+    }
+    {
+        // select leaves exactly one of its two values on the stack
+        for (int32_t condition = 0; condition < 2; condition++) {
+            WasmintVM vm;
+
+            Module* module = ModuleParser::parse("module (func $main (result i32) (i32.add (i32.const 100) "
+                                                 "(select (i32.const 4) (i32.const 5) (i32.const " + std::to_string(condition) + "))))");
+            vm.loadModule(*module, true);
+            vm.startAtFunction(*module->functions().front());
+            vm.stepUntilFinished();
+            assert(!vm.gotTrap());
+            assert(vm.state().thread().result().int32() == (condition ? 104 : 105));
+        }
+    }
 
 }
\ No newline at end of file
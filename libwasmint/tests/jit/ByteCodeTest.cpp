@@ -0,0 +1,44 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cassert>
+#include <limits>
+#include <interpreter/ByteCode.h>
+
+using namespace wasmint;
+
+int main() {
+    ByteCode code;
+
+    std::vector<uint32_t> immediates = {0, 1, 127, 128, 300, 65535, 1u << 28, std::numeric_limits<uint32_t>::max()};
+
+    for (uint32_t immediate : immediates) {
+        code.appendOpcode(ByteOpcodes::I32Load);
+        code.appendImmediate(immediate);
+    }
+    code.appendOpcode(ByteOpcodes::End);
+
+    uint32_t position = 0;
+    for (uint32_t immediate : immediates) {
+        assert(position % ByteCode::instructionAlignment == 0);
+        assert(code.get<ByteCode::OpcodeWord>(position) == ByteOpcodes::I32Load);
+        position += sizeof(ByteCode::OpcodeWord);
+        assert(code.getImmediate(position) == immediate);
+    }
+    assert(code.get<ByteCode::OpcodeWord>(position) == ByteOpcodes::End);
+    assert(position + sizeof(ByteCode::OpcodeWord) == code.size());
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <iostream>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// Runs the given module once in the interpreter and once natively and checks that both end in the same state.
+void compareWithInterpreter(const std::string& source) {
+    WasmintVM interpretedVM;
+    interpretedVM.nativeExecution(false);
+    Module* interpretedModule = ModuleParser::parse(source);
+    interpretedVM.loadModule(*interpretedModule, true);
+    interpretedVM.startAtFunction(*interpretedModule->functions().front());
+    interpretedVM.stepUntilFinished();
+
+    WasmintVM nativeVM;
+    nativeVM.tieringPolicy(TieringPolicy::eager());
+    Module* nativeModule = ModuleParser::parse(source);
+    nativeVM.loadModule(*nativeModule, true);
+    nativeVM.startAtFunction(*nativeModule->functions().front());
+    nativeVM.stepUntilFinished();
+
+    if (interpretedVM.instructionCounter() != nativeVM.instructionCounter()) {
+        std::cerr << "Executed " << nativeVM.instructionCounter().toString() << " native instructions, but "
+                  << interpretedVM.instructionCounter().toString() << " in the interpreter for " << source << std::endl;
+    }
+    assert(interpretedVM.instructionCounter() == nativeVM.instructionCounter());
+    assert(interpretedVM.trapReason() == nativeVM.trapReason());
+    assert(interpretedVM.state().thread().result() == nativeVM.state().thread().result());
+    assert(interpretedVM.heap() == nativeVM.heap());
+}
+
+int main() {
+    // integer arithmetic, locals and loops
+    compareWithInterpreter("module (func $main (result i64) (local $i i32) (local $sum i64) "
+                                   "(loop $exit $cont "
+                                   "(set_local $sum (i64.add (get_local $sum) (i64.xor (i64.const 12345) (i64.mul (get_local $sum) (i64.const 3))))) "
+                                   "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                                   "(br_if $cont (i32.lt_u (get_local $i) (i32.const 10000)))) "
+                                   "(get_local $sum))");
+    // stores through the interpreter and inline loads
+    compareWithInterpreter("module (memory 1 1) (func $main (result i32) (local $i i32) (local $sum i32) "
+                                   "(loop $exit $cont "
+                                   "(i32.store8 (get_local $i) (i32.mul (get_local $i) (i32.const 7))) "
+                                   "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                                   "(br_if $cont (i32.lt_u (get_local $i) (i32.const 1000)))) "
+                                   "(set_local $i (i32.const 0)) "
+                                   "(loop $exit2 $cont2 "
+                                   "(set_local $sum (i32.add (get_local $sum) (i32.load8_u (get_local $i)))) "
+                                   "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                                   "(br_if $cont2 (i32.lt_u (get_local $i) (i32.const 1000)))) "
+                                   "(get_local $sum))");
+    // signed comparisons
+    compareWithInterpreter("module (func $main (result i32) "
+                                   "(if_else (i32.gt_s (i32.const -5) (i32.const 3)) (i32.const 1) (i32.const 2)))");
+    // values left on the stack in a loop make the native code grow the stack
+    compareWithInterpreter("module (func $main (result i32) (local $i i32) "
+                                   "(loop $exit $cont (i32.const 77) "
+                                   "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                                   "(br_if $cont (i32.lt_u (get_local $i) (i32.const 1000)))) "
+                                   "(get_local $i))");
+    // out of bounds load in the native code
+    compareWithInterpreter("module (memory 1 1) (func $main (result i32) (local $i i32) "
+                                   "(loop $exit $cont (i32.load (get_local $i)) "
+                                   "(set_local $i (i32.add (get_local $i) (i32.const 4))) "
+                                   "(br_if $cont (i32.lt_u (get_local $i) (i32.const 70000)))) "
+                                   "(get_local $i))");
+    // trap raised by the interpreter on behalf of the native code
+    compareWithInterpreter("module (func $main (result i32) (i32.div_s (i32.const 1) (i32.const 0)))");
+}
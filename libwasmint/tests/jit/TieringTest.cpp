@@ -0,0 +1,68 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+std::string loopWithIterations(uint32_t iterations) {
+    return "module (func $main (result i32) (local $i i32) "
+                   "(loop $exit $cont "
+                   "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                   "(br_if $cont (i32.lt_u (get_local $i) (i32.const " + std::to_string(iterations) + ")))) "
+                   "(get_local $i))";
+}
+
+int main() {
+    {
+        // cold code stays in the interpreter
+        WasmintVM vm;
+        vm.tieringPolicy(TieringPolicy(10, 100));
+        Module* module = ModuleParser::parse(loopWithIterations(50));
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.stepUntilFinished();
+
+        assert(vm.getCompiledFunction(0).callCount() == 1);
+        assert(vm.getCompiledFunction(0).backEdgeCount() == 49);
+        assert(vm.state().thread().result().int32() == 50);
+#ifdef WASMINT_NATIVE_JIT
+        assert(!vm.getCompiledFunction(0).promoted());
+#endif
+    }
+    {
+        // a hot loop is promoted while it runs and the interpreter stops counting afterwards
+        WasmintVM vm;
+        vm.tieringPolicy(TieringPolicy(10, 100));
+        Module* module = ModuleParser::parse(loopWithIterations(5000));
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->functions().front());
+        vm.stepUntilFinished();
+
+        assert(vm.state().thread().result().int32() == 5000);
+#ifdef WASMINT_NATIVE_JIT
+        assert(vm.getCompiledFunction(0).promoted());
+        assert(vm.getCompiledFunction(0).backEdgeCount() == 100);
+#endif
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+uint32_t sideEffects = 0;
+
+int32_t subtract(int32_t a, int32_t b) {
+    return a - b;
+}
+
+Module* createHostModule() {
+    Module* module = new Module();
+    module->context().name("host");
+    module->addTypedFunction("sub", &subtract);
+    module->addTypedFunction<int64_t(int64_t, int32_t)>("shift", [](int64_t value, int32_t amount) {
+        return value << amount;
+    });
+    module->addTypedFunction<void(int32_t)>("count", [](int32_t value) {
+        sideEffects += value;
+    });
+    return module;
+}
+
+int64_t run(const TieringPolicy& policy) {
+    sideEffects = 0;
+    WasmintVM vm;
+    vm.tieringPolicy(policy);
+    vm.loadModule(*createHostModule(), true);
+
+    Module* module = ModuleParser::parse(
+            "module "
+            "(import $sub \"host\" \"sub\" (param i32 i32) (result i32))"
+            "(import $shift \"host\" \"shift\" (param i64 i32) (result i64))"
+            "(import $count \"host\" \"count\" (param i32))"
+            "(func $main (result i64) (local $i i32) "
+                "(loop $exit $cont "
+                    "(call_import $count (i32.const 2)) "
+                    "(set_local $i (call_import $sub (get_local $i) (i32.const -1))) "
+                    "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100)))) "
+                "(call_import $shift (i64.extend_u/i32 (call_import $sub (i32.const 7) (get_local $i))) (i32.const 4)))");
+    vm.loadModule(*module, true);
+    vm.startAtFunction(*module->functions().front());
+    vm.stepUntilFinished();
+
+    assert(!vm.gotTrap());
+    assert(sideEffects == 200);
+    return vm.state().thread().result().int64();
+}
+
+int main() {
+    // the parameters must arrive in declaration order
+    assert(run(TieringPolicy()) == ((int64_t) (7 - 100) & 0xFFFFFFFF) << 4);
+    assert(run(TieringPolicy::eager()) == ((int64_t) (7 - 100) & 0xFFFFFFFF) << 4);
+}
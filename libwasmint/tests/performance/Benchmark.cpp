@@ -0,0 +1,297 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/at/MachineState.h>
+
+namespace wasmint {
+
+    namespace {
+        int32_t atResult = 0;
+
+        // returns the text after "key": in the given line of the output of writeJson
+        std::string jsonValue(const std::string& line, const std::string& key) {
+            std::string pattern = "\"" + key + "\": ";
+            std::size_t start = line.find(pattern);
+            if (start == std::string::npos)
+                throw BenchmarkFailed("Missing " + key + " in benchmark result " + line);
+            return line.substr(start + pattern.size());
+        }
+
+        std::string jsonString(const std::string& line, const std::string& key) {
+            std::string value = jsonValue(line, key);
+            std::size_t end = value.find('"', 1);
+            if (value.empty() || value[0] != '"' || end == std::string::npos)
+                throw BenchmarkFailed("Malformed " + key + " in benchmark result " + line);
+            return value.substr(1, end - 1);
+        }
+
+        wasm_module::Module* createATResultModule() {
+            wasm_module::Module* module = new wasm_module::Module();
+            module->context().name("benchmark");
+            module->addTypedFunction<int32_t(int32_t)>("result", [](int32_t value) {
+                atResult = value;
+                return value;
+            });
+            return module;
+        }
+    }
+
+    BenchmarkRun VMBenchmarkEngine::run(const BenchmarkWorkload& workload) {
+        WasmintVM vm;
+        vm.nativeExecution(nativeExecution_);
+        vm.loadModuleFromData(workload.source);
+        vm.startAtFunction(*vm.modules().front()->function("$main"), history_);
+
+        BenchmarkRun result;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        vm.stepUntilFinished();
+        result.duration = std::chrono::steady_clock::now() - start;
+
+        if (vm.gotTrap())
+            throw BenchmarkFailed(workload.name + " trapped on " + name() + ": " + vm.trapReason());
+        result.hasResult = true;
+        result.result = vm.state().thread().result().int32();
+        return result;
+    }
+
+    uint64_t VMBenchmarkEngine::countInstructions(const BenchmarkWorkload& workload) {
+        WasmintVM vm;
+        vm.nativeExecution(false);
+        vm.loadModuleFromData(workload.source);
+        vm.startAtFunction(*vm.modules().front()->function("$main"), false);
+        vm.stepUntilFinished();
+        return vm.instructionCounter().toUint64();
+    }
+
+    BenchmarkRun ATBenchmarkEngine::run(const BenchmarkWorkload& workload) {
+        // the AST interpreter drops the result of the function it started at, so the result of
+        // $main is passed to a native function instead
+        wasm_module::Module* module = wasm_module::sexpr::ModuleParser::parse(workload.source
+            + " (import $benchmarkResult \"benchmark\" \"result\" (param i32) (result i32))"
+            + " (func $benchmarkMain (result i32) (call_import $benchmarkResult (call $main)))");
+
+        MachineState environment;
+        environment.useModule(*createATResultModule(), true);
+        environment.useModule(*module, true);
+        InterpreterThread& thread = environment.createThread().startAtFunction(module->name(), "$benchmarkMain");
+
+        BenchmarkRun result;
+        atResult = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        thread.stepUntilFinished();
+        result.duration = std::chrono::steady_clock::now() - start;
+
+        if (thread.gotTrap())
+            throw BenchmarkFailed(workload.name + " trapped on " + name() + ": " + thread.trapReason());
+        result.hasResult = true;
+        result.result = atResult;
+        return result;
+    }
+
+    Wasm2cBenchmarkEngine::~Wasm2cBenchmarkEngine() {
+        removeFiles();
+        if (!directory_.empty())
+            rmdir(directory_.c_str());
+    }
+
+    void Wasm2cBenchmarkEngine::removeFiles() {
+        for (const std::string& file : files_) {
+            std::remove(file.c_str());
+        }
+        files_.clear();
+    }
+
+    void Wasm2cBenchmarkEngine::prepare(const BenchmarkWorkload& workload) {
+        if (directory_.empty()) {
+            char directoryTemplate[] = "/tmp/wasmint_bench_XXXXXX";
+            if (mkdtemp(directoryTemplate) == nullptr)
+                throw BenchmarkFailed("Can't create a temporary directory for wasm2c");
+            directory_ = directoryTemplate;
+        }
+        // only the files of the workload that is run next are needed
+        removeFiles();
+
+        // wasm2c expects s-expression modules to end with .wasm
+        const std::string modulePath = directory_ + "/" + workload.name + ".wasm";
+        const std::string sourcePath = modulePath + ".c";
+        binaryPath_ = modulePath + ".binary";
+        files_ = {modulePath, sourcePath, binaryPath_};
+
+        std::ofstream moduleFile(modulePath);
+        moduleFile << "(" << workload.source << ")";
+        moduleFile.close();
+        if (!moduleFile)
+            throw BenchmarkFailed("Can't write " + modulePath);
+
+        if (std::system((wasm2c_ + " " + modulePath + " > " + sourcePath).c_str()) != 0)
+            throw BenchmarkFailed("wasm2c failed to convert " + workload.name);
+        if (std::system((compiler_ + " -O2 " + sourcePath + " -o " + binaryPath_ + " -lm").c_str()) != 0)
+            throw BenchmarkFailed("Failed to compile the C source of " + workload.name);
+    }
+
+    BenchmarkRun Wasm2cBenchmarkEngine::run(const BenchmarkWorkload& workload) {
+        BenchmarkRun result;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int status = std::system(binaryPath_.c_str());
+        result.duration = std::chrono::steady_clock::now() - start;
+
+        if (status != 0)
+            throw BenchmarkFailed(workload.name + " failed on " + name() + " with status " + std::to_string(status));
+        return result;
+    }
+
+    BenchmarkStatistics BenchmarkStatistics::compute(const std::vector<double>& samples) {
+        BenchmarkStatistics result;
+        result.samples = samples;
+        if (samples.empty())
+            return result;
+
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        std::size_t middle = sorted.size() / 2;
+        if (sorted.size() % 2 == 0)
+            result.median = (sorted[middle - 1] + sorted[middle]) / 2;
+        else
+            result.median = sorted[middle];
+
+        // nearest rank, so the p95 of less than 20 samples is the slowest run
+        std::size_t rank = (std::size_t) std::ceil(0.95 * sorted.size());
+        result.p95 = sorted[rank - 1];
+
+        double sum = 0;
+        for (double sample : sorted) {
+            sum += sample;
+        }
+        result.mean = sum / sorted.size();
+        result.min = sorted.front();
+        result.max = sorted.back();
+        return result;
+    }
+
+    double BenchmarkResult::instructionsPerSecond() const {
+        if (statistics.median <= 0)
+            return 0;
+        return instructions / (statistics.median / 1e9);
+    }
+
+    BenchmarkResult BenchmarkRunner::run(BenchmarkEngine& engine, const BenchmarkWorkload& workload) {
+        auto instructions = instructions_.find(workload.name);
+        if (instructions == instructions_.end()) {
+            instructions = instructions_.insert(std::make_pair(workload.name,
+                                                               VMBenchmarkEngine::countInstructions(workload))).first;
+        }
+
+        engine.prepare(workload);
+
+        std::vector<double> samples;
+        for (std::size_t i = 0; i < warmup_ + repetitions_; i++) {
+            BenchmarkRun run = engine.run(workload);
+            if (run.hasResult && run.result != workload.expectedResult) {
+                throw BenchmarkFailed(workload.name + " returned " + std::to_string(run.result) + " on "
+                                      + engine.name() + " instead of " + std::to_string(workload.expectedResult));
+            }
+            if (i >= warmup_)
+                samples.push_back((double) run.duration.count());
+        }
+
+        BenchmarkResult result;
+        result.workload = workload.name;
+        result.engine = engine.name();
+        result.instructions = instructions->second;
+        result.statistics = BenchmarkStatistics::compute(samples);
+        return result;
+    }
+
+    void BenchmarkRunner::print(std::ostream& output, const std::vector<BenchmarkResult>& results) const {
+        output << std::left << std::setw(16) << "workload" << std::setw(10) << "engine"
+               << std::right << std::setw(14) << "median ms" << std::setw(14) << "p95 ms"
+               << std::setw(16) << "MInstr/s" << "\n";
+        output << std::fixed << std::setprecision(3);
+        for (const BenchmarkResult& result : results) {
+            output << std::left << std::setw(16) << result.workload << std::setw(10) << result.engine
+                   << std::right << std::setw(14) << result.statistics.median / 1e6
+                   << std::setw(14) << result.statistics.p95 / 1e6
+                   << std::setw(16) << result.instructionsPerSecond() / 1e6 << "\n";
+        }
+    }
+
+    void BenchmarkRunner::writeJson(std::ostream& output, const std::vector<BenchmarkResult>& results) const {
+        output << "{\n  \"warmup\": " << warmup_ << ",\n  \"repetitions\": " << repetitions_ << ",\n  \"results\": [";
+        output << std::fixed << std::setprecision(0);
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const BenchmarkResult& result = results[i];
+            const BenchmarkStatistics& statistics = result.statistics;
+            output << (i == 0 ? "\n" : ",\n")
+                   << "    {\"workload\": \"" << result.workload << "\", \"engine\": \"" << result.engine << "\""
+                   << ", \"instructions\": " << result.instructions
+                   << ", \"median_ns\": " << statistics.median << ", \"p95_ns\": " << statistics.p95
+                   << ", \"mean_ns\": " << statistics.mean << ", \"min_ns\": " << statistics.min
+                   << ", \"max_ns\": " << statistics.max
+                   << ", \"instructions_per_second\": " << result.instructionsPerSecond()
+                   << ", \"samples_ns\": [";
+            for (std::size_t j = 0; j < statistics.samples.size(); j++) {
+                output << (j == 0 ? "" : ", ") << statistics.samples[j];
+            }
+            output << "]}";
+        }
+        output << "\n  ]\n}\n";
+    }
+
+    std::vector<BenchmarkResult> BenchmarkRunner::readJson(std::istream& input) {
+        std::vector<BenchmarkResult> results;
+        std::string line;
+        // writeJson puts every result on its own line
+        while (std::getline(input, line)) {
+            if (line.find("\"workload\": ") == std::string::npos)
+                continue;
+
+            BenchmarkResult result;
+            result.workload = jsonString(line, "workload");
+            result.engine = jsonString(line, "engine");
+            result.instructions = std::stoull(jsonValue(line, "instructions"));
+
+            std::string samples = jsonValue(line, "samples_ns");
+            std::size_t end = samples.find(']');
+            if (samples.empty() || samples[0] != '[' || end == std::string::npos)
+                throw BenchmarkFailed("Malformed samples_ns in benchmark result " + line);
+            std::istringstream sampleStream(samples.substr(1, end - 1));
+            std::vector<double> values;
+            std::string sample;
+            while (std::getline(sampleStream, sample, ',')) {
+                values.push_back(std::stod(sample));
+            }
+            result.statistics = BenchmarkStatistics::compute(values);
+            results.push_back(result);
+        }
+        return results;
+    }
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_BENCHMARK_H
+#define WASMINT_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <ExceptionWithMessage.h>
+
+namespace wasmint {
+
+    ExceptionMessage(BenchmarkFailed)
+
+    /**
+     * A module whose $main function is the measured work. $main returns an i32 checksum which has
+     * to match expectedResult on every engine that can report it.
+     */
+    struct BenchmarkWorkload {
+        std::string name;
+        std::string source;
+        int32_t expectedResult;
+
+        BenchmarkWorkload(const std::string& name, const std::string& source, int32_t expectedResult)
+                : name(name), source(source), expectedResult(expectedResult) {
+        }
+    };
+
+    /**
+     * Result of running a workload once.
+     */
+    struct BenchmarkRun {
+        std::chrono::nanoseconds duration{0};
+        // false if the engine can't report the result of $main
+        bool hasResult = false;
+        int32_t result = 0;
+    };
+
+    /**
+     * One way of executing a workload, e.g. the bytecode VM or the code generated by wasm2c.
+     */
+    class BenchmarkEngine {
+    public:
+        virtual ~BenchmarkEngine() {
+        }
+
+        virtual std::string name() const = 0;
+
+        /**
+         * Called once before the workload is run. Work done here is not measured.
+         */
+        virtual void prepare(const BenchmarkWorkload&) {
+        }
+
+        /**
+         * Executes $main of the prepared workload. Only the execution itself is part of the
+         * returned duration, parsing and compiling the module is not.
+         */
+        virtual BenchmarkRun run(const BenchmarkWorkload& workload) = 0;
+    };
+
+    /**
+     * Runs the bytecode interpreter of WasmintVM, optionally with native code for hot functions.
+     * The name doesn't depend on the history, so runs with and without it can be compared.
+     */
+    class VMBenchmarkEngine : public BenchmarkEngine {
+        bool nativeExecution_;
+        bool history_;
+    public:
+        VMBenchmarkEngine(bool nativeExecution, bool history = false)
+                : nativeExecution_(nativeExecution), history_(history) {
+        }
+
+        virtual std::string name() const override {
+            return nativeExecution_ ? "native" : "bytecode";
+        }
+
+        virtual BenchmarkRun run(const BenchmarkWorkload& workload) override;
+
+        /**
+         * Number of instructions the bytecode interpreter executes for the workload. This is the
+         * unit of work for the instructions per second of all engines.
+         */
+        static uint64_t countInstructions(const BenchmarkWorkload& workload);
+    };
+
+    /**
+     * Runs the AST interpreter MachineState.
+     */
+    class ATBenchmarkEngine : public BenchmarkEngine {
+    public:
+        virtual std::string name() const override {
+            return "at";
+        }
+
+        virtual BenchmarkRun run(const BenchmarkWorkload& workload) override;
+    };
+
+    /**
+     * Converts the workload with wasm2c, compiles the C source and runs the resulting program.
+     * The generated main() ignores the result of $main, so the checksum can't be checked and
+     * the duration includes starting the process. The generated files are kept in a temporary
+     * directory that is removed with the engine.
+     */
+    class Wasm2cBenchmarkEngine : public BenchmarkEngine {
+        std::string wasm2c_;
+        std::string compiler_;
+        std::string directory_;
+        std::vector<std::string> files_;
+        std::string binaryPath_;
+
+        void removeFiles();
+
+    public:
+        Wasm2cBenchmarkEngine(const std::string& wasm2c, const std::string& compiler)
+                : wasm2c_(wasm2c), compiler_(compiler) {
+        }
+
+        Wasm2cBenchmarkEngine(const Wasm2cBenchmarkEngine&) = delete;
+        Wasm2cBenchmarkEngine& operator=(const Wasm2cBenchmarkEngine&) = delete;
+
+        virtual ~Wasm2cBenchmarkEngine();
+
+        virtual std::string name() const override {
+            return "wasm2c";
+        }
+
+        virtual void prepare(const BenchmarkWorkload& workload) override;
+
+        virtual BenchmarkRun run(const BenchmarkWorkload& workload) override;
+    };
+
+    /**
+     * Summary of the durations of the measured runs in nanoseconds.
+     */
+    struct BenchmarkStatistics {
+        std::vector<double> samples;
+        double median = 0;
+        double p95 = 0;
+        double mean = 0;
+        double min = 0;
+        double max = 0;
+
+        static BenchmarkStatistics compute(const std::vector<double>& samples);
+    };
+
+    struct BenchmarkResult {
+        std::string workload;
+        std::string engine;
+        uint64_t instructions = 0;
+        BenchmarkStatistics statistics;
+
+        /**
+         * Instructions of the bytecode interpreter per second of the median run.
+         */
+        double instructionsPerSecond() const;
+    };
+
+    /**
+     * Runs each workload a few times without measuring it and then the given number of
+     * repetitions. Runs whose checksum doesn't match the workload throw BenchmarkFailed.
+     */
+    class BenchmarkRunner {
+        std::size_t warmup_ = 2;
+        std::size_t repetitions_ = 10;
+        std::map<std::string, uint64_t> instructions_;
+
+    public:
+        BenchmarkResult run(BenchmarkEngine& engine, const BenchmarkWorkload& workload);
+
+        std::size_t warmup() const {
+            return warmup_;
+        }
+
+        void warmup(std::size_t runs) {
+            warmup_ = runs;
+        }
+
+        std::size_t repetitions() const {
+            return repetitions_;
+        }
+
+        void repetitions(std::size_t runs) {
+            repetitions_ = runs;
+        }
+
+        void print(std::ostream& output, const std::vector<BenchmarkResult>& results) const;
+
+        /**
+         * Writes the results and all samples for regression tracking.
+         */
+        void writeJson(std::ostream& output, const std::vector<BenchmarkResult>& results) const;
+
+        /**
+         * Reads the results of writeJson back. The statistics are computed again from the samples.
+         */
+        static std::vector<BenchmarkResult> readJson(std::istream& input);
+    };
+}
+
+#endif //WASMINT_BENCHMARK_H
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+#include "BenchmarkComparison.h"
+
+using namespace wasmint;
+
+void printUsage() {
+    std::cerr << "Usage: wasmint_bench_compare --baseline COMMAND --candidate COMMAND [--rounds N] [--warmup N] "
+                 "[--repetitions N] [--workload NAME]... [--engine NAME]... [--confidence LEVEL] "
+                 "[--max-regression PERCENT]\n"
+                 "Both commands are wasmint_bench invocations, e.g. \"old/wasmint_bench\" and "
+                 "\"new/wasmint_bench --history\".\n"
+                 "Each round runs both commands once in alternating order, warmup and repetitions are per run."
+              << std::endl;
+}
+
+/**
+ * A temporary directory for the JSON results of both builds. It is removed with the results, so
+ * comparisons can run at the same time and don't leave files behind.
+ */
+class ResultDirectory {
+    std::string path_;
+
+public:
+    ResultDirectory() {
+        char directoryTemplate[] = "/tmp/wasmint_bench_compare_XXXXXX";
+        if (mkdtemp(directoryTemplate) == nullptr)
+            throw BenchmarkFailed("Can't create a temporary directory for the results");
+        path_ = directoryTemplate;
+    }
+
+    ResultDirectory(const ResultDirectory&) = delete;
+    ResultDirectory& operator=(const ResultDirectory&) = delete;
+
+    ~ResultDirectory() {
+        std::remove(baselinePath().c_str());
+        std::remove(candidatePath().c_str());
+        rmdir(path_.c_str());
+    }
+
+    std::string baselinePath() const {
+        return path_ + "/baseline.json";
+    }
+
+    std::string candidatePath() const {
+        return path_ + "/candidate.json";
+    }
+};
+
+std::vector<BenchmarkResult> runBuild(const std::string& command, const std::string& arguments,
+                                      const std::string& jsonPath) {
+    std::string commandLine = command + arguments + " --json " + jsonPath + " > /dev/null";
+    if (std::system(commandLine.c_str()) != 0)
+        throw BenchmarkFailed("Failed to run " + commandLine);
+
+    std::ifstream jsonFile(jsonPath);
+    if (!jsonFile)
+        throw BenchmarkFailed("Can't read the results of " + command + " from " + jsonPath);
+    return BenchmarkRunner::readJson(jsonFile);
+}
+
+int main(int argc, char** argv) {
+    std::string baselineCommand;
+    std::string candidateCommand;
+    std::size_t rounds = 10;
+    std::size_t warmup = 1;
+    std::size_t repetitions = 3;
+    double confidence = 0.95;
+    double maxRegression = -1;
+    std::string forwardedArguments;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc) {
+            baselineCommand = argv[++i];
+        } else if (arg == "--candidate" && i + 1 < argc) {
+            candidateCommand = argv[++i];
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            rounds = (std::size_t) std::stoul(argv[++i]);
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            warmup = (std::size_t) std::stoul(argv[++i]);
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = (std::size_t) std::stoul(argv[++i]);
+        } else if ((arg == "--workload" || arg == "--engine") && i + 1 < argc) {
+            forwardedArguments += " " + arg + " " + argv[++i];
+        } else if (arg == "--confidence" && i + 1 < argc) {
+            confidence = std::stod(argv[++i]);
+        } else if (arg == "--max-regression" && i + 1 < argc) {
+            maxRegression = std::stod(argv[++i]) / 100;
+        } else if (arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (baselineCommand.empty() || candidateCommand.empty()) {
+        std::cerr << "Both a baseline and a candidate command are needed" << std::endl;
+        printUsage();
+        return 2;
+    }
+    if (rounds == 0 || repetitions == 0 || confidence <= 0 || confidence >= 1) {
+        std::cerr << "At least one round and repetition and a confidence between 0 and 1 are needed" << std::endl;
+        return 2;
+    }
+
+    const std::string arguments = " --warmup " + std::to_string(warmup)
+                                  + " --repetitions " + std::to_string(repetitions) + forwardedArguments;
+
+    std::vector<BenchmarkResult> baselineResults;
+    std::vector<BenchmarkResult> candidateResults;
+    std::vector<BenchmarkComparison> comparisons;
+    try {
+        ResultDirectory resultDirectory;
+        for (std::size_t round = 0; round < rounds; round++) {
+            // alternating the order spreads slow drifts of the machine evenly over both builds
+            bool baselineFirst = round % 2 == 0;
+            for (int run = 0; run < 2; run++) {
+                if (baselineFirst == (run == 0)) {
+                    mergeBenchmarkResults(baselineResults, runBuild(baselineCommand, arguments,
+                                                                    resultDirectory.baselinePath()));
+                } else {
+                    mergeBenchmarkResults(candidateResults, runBuild(candidateCommand, arguments,
+                                                                     resultDirectory.candidatePath()));
+                }
+            }
+            std::cerr << "Finished round " << (round + 1) << " of " << rounds << std::endl;
+        }
+
+        for (const BenchmarkResult& baseline : baselineResults) {
+            auto candidate = std::find_if(candidateResults.begin(), candidateResults.end(),
+                                          [&](const BenchmarkResult& result) {
+                return result.workload == baseline.workload && result.engine == baseline.engine;
+            });
+            if (candidate == candidateResults.end()) {
+                std::cerr << "The candidate has no results for " << baseline.workload << " on "
+                          << baseline.engine << std::endl;
+                continue;
+            }
+            comparisons.push_back(BenchmarkComparison::compute(baseline, *candidate, confidence));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Comparison failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    printBenchmarkComparisons(std::cout, comparisons, confidence);
+
+    if (maxRegression >= 0) {
+        for (const BenchmarkComparison& comparison : comparisons) {
+            if (comparison.significant() && comparison.change > maxRegression) {
+                std::cerr << comparison.workload << " on " << comparison.engine << " regressed by more than "
+                          << maxRegression * 100 << "%" << std::endl;
+                return 1;
+            }
+        }
+    }
+}
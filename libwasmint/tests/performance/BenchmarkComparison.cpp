@@ -0,0 +1,116 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "BenchmarkComparison.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace wasmint {
+
+    namespace {
+        double median(std::vector<double>& values) {
+            std::size_t middle = values.size() / 2;
+            std::nth_element(values.begin(), values.begin() + middle, values.end());
+            double result = values[middle];
+            if (values.size() % 2 == 0) {
+                result = (result + *std::max_element(values.begin(), values.begin() + middle)) / 2;
+            }
+            return result;
+        }
+
+        double resampledMedian(const std::vector<double>& samples, std::vector<double>& buffer, std::mt19937& generator) {
+            std::uniform_int_distribution<std::size_t> index(0, samples.size() - 1);
+            buffer.resize(samples.size());
+            for (double& value : buffer) {
+                value = samples[index(generator)];
+            }
+            return median(buffer);
+        }
+    }
+
+    BenchmarkComparison BenchmarkComparison::compute(const BenchmarkResult& baseline, const BenchmarkResult& candidate,
+                                                     double confidence, std::size_t resamples, uint32_t seed) {
+        BenchmarkComparison result;
+        result.workload = baseline.workload;
+        result.engine = baseline.engine;
+        result.baseline = baseline.statistics;
+        result.candidate = candidate.statistics;
+
+        if (result.baseline.samples.empty() || result.candidate.samples.empty() || result.baseline.median <= 0)
+            throw BenchmarkFailed("Can't compare " + baseline.workload + " on " + baseline.engine + " without samples");
+        result.change = result.candidate.median / result.baseline.median - 1;
+
+        std::mt19937 generator(seed);
+        std::vector<double> buffer;
+        std::vector<double> changes;
+        changes.reserve(resamples);
+        for (std::size_t i = 0; i < resamples; i++) {
+            double baselineMedian = resampledMedian(result.baseline.samples, buffer, generator);
+            double candidateMedian = resampledMedian(result.candidate.samples, buffer, generator);
+            changes.push_back(candidateMedian / baselineMedian - 1);
+        }
+        std::sort(changes.begin(), changes.end());
+
+        double tail = (1 - confidence) / 2;
+        result.lowerBound = changes[(std::size_t) (tail * (changes.size() - 1))];
+        result.upperBound = changes[(std::size_t) ((1 - tail) * (changes.size() - 1))];
+        return result;
+    }
+
+    void mergeBenchmarkResults(std::vector<BenchmarkResult>& merged, const std::vector<BenchmarkResult>& results) {
+        for (const BenchmarkResult& result : results) {
+            auto existing = std::find_if(merged.begin(), merged.end(), [&](const BenchmarkResult& other) {
+                return other.workload == result.workload && other.engine == result.engine;
+            });
+            if (existing == merged.end()) {
+                merged.push_back(result);
+            } else {
+                std::vector<double> samples = existing->statistics.samples;
+                samples.insert(samples.end(), result.statistics.samples.begin(), result.statistics.samples.end());
+                existing->statistics = BenchmarkStatistics::compute(samples);
+            }
+        }
+    }
+
+    void printBenchmarkComparisons(std::ostream& output, const std::vector<BenchmarkComparison>& comparisons,
+                                   double confidence) {
+        output << std::left << std::setw(16) << "workload" << std::setw(10) << "engine"
+               << std::right << std::setw(14) << "baseline ms" << std::setw(14) << "candidate ms"
+               << std::setw(10) << "change" << std::setw(24)
+               << (std::to_string((int) (confidence * 100)) + "% interval") << "  verdict\n";
+        output << std::fixed;
+        for (const BenchmarkComparison& comparison : comparisons) {
+            std::string verdict = "no significant change";
+            if (comparison.significant())
+                verdict = comparison.change > 0 ? "slower" : "faster";
+
+            std::ostringstream interval;
+            interval << std::fixed << std::setprecision(1) << std::showpos
+                     << "[" << comparison.lowerBound * 100 << "%, " << comparison.upperBound * 100 << "%]";
+
+            output << std::left << std::setw(16) << comparison.workload << std::setw(10) << comparison.engine
+                   << std::right << std::setprecision(3)
+                   << std::setw(14) << comparison.baseline.median / 1e6
+                   << std::setw(14) << comparison.candidate.median / 1e6
+                   << std::setprecision(1) << std::showpos << std::setw(9) << comparison.change * 100 << "%"
+                   << std::noshowpos << std::setw(24) << interval.str() << "  " << verdict << "\n";
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_BENCHMARKCOMPARISON_H
+#define WASMINT_BENCHMARKCOMPARISON_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Benchmark.h"
+
+namespace wasmint {
+
+    /**
+     * Relative change of the median duration of a workload from a baseline to a candidate build.
+     * The confidence interval is a percentile bootstrap, so it doesn't assume that the durations
+     * are normally distributed.
+     */
+    struct BenchmarkComparison {
+        std::string workload;
+        std::string engine;
+        BenchmarkStatistics baseline;
+        BenchmarkStatistics candidate;
+        // candidate median / baseline median - 1, positive values mean the candidate is slower
+        double change = 0;
+        double lowerBound = 0;
+        double upperBound = 0;
+
+        /**
+         * True if the confidence interval doesn't contain zero.
+         */
+        bool significant() const {
+            return lowerBound > 0 || upperBound < 0;
+        }
+
+        /**
+         * Compares the samples of both results by resampling them the given number of times.
+         * The seed makes the interval reproducible for the same samples.
+         */
+        static BenchmarkComparison compute(const BenchmarkResult& baseline, const BenchmarkResult& candidate,
+                                           double confidence = 0.95, std::size_t resamples = 2000,
+                                           uint32_t seed = 0);
+    };
+
+    /**
+     * Merges the samples of results with the same workload and engine, e.g. the results of all
+     * rounds of one build.
+     */
+    void mergeBenchmarkResults(std::vector<BenchmarkResult>& merged, const std::vector<BenchmarkResult>& results);
+
+    void printBenchmarkComparisons(std::ostream& output, const std::vector<BenchmarkComparison>& comparisons,
+                                   double confidence);
+}
+
+#endif //WASMINT_BENCHMARKCOMPARISON_H
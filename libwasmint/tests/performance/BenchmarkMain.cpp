@@ -0,0 +1,150 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "Benchmark.h"
+#include "BenchmarkWorkloads.h"
+
+using namespace wasmint;
+
+void printUsage() {
+    std::cerr << "Usage: wasmint_bench [--warmup N] [--repetitions N] [--workload NAME]... [--engine NAME]... "
+                 "[--history] [--json FILE]\n"
+                 "Engines: bytecode"
+#ifdef WASMINT_NATIVE_JIT
+                 ", native"
+#endif
+                 ", at"
+#ifdef WASMINT_BENCH_WASM2C
+                 ", wasm2c"
+#endif
+              << std::endl;
+}
+
+std::unique_ptr<BenchmarkEngine> createEngine(const std::string& name, bool history) {
+    if (name == "bytecode")
+        return std::unique_ptr<BenchmarkEngine>(new VMBenchmarkEngine(false, history));
+#ifdef WASMINT_NATIVE_JIT
+    if (name == "native")
+        return std::unique_ptr<BenchmarkEngine>(new VMBenchmarkEngine(true, history));
+#endif
+    if (name == "at")
+        return std::unique_ptr<BenchmarkEngine>(new ATBenchmarkEngine());
+#ifdef WASMINT_BENCH_WASM2C
+    if (name == "wasm2c")
+        return std::unique_ptr<BenchmarkEngine>(new Wasm2cBenchmarkEngine(WASMINT_BENCH_WASM2C, WASMINT_BENCH_CC));
+#endif
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner;
+    std::vector<std::string> workloadNames;
+    std::vector<std::string> engineNames;
+    std::string jsonPath;
+    bool history = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--warmup" && i + 1 < argc) {
+            runner.warmup((std::size_t) std::stoul(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            runner.repetitions((std::size_t) std::stoul(argv[++i]));
+        } else if (arg == "--workload" && i + 1 < argc) {
+            workloadNames.push_back(argv[++i]);
+        } else if (arg == "--engine" && i + 1 < argc) {
+            engineNames.push_back(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--history") {
+            history = true;
+        } else if (arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (runner.repetitions() == 0) {
+        std::cerr << "At least one repetition is needed" << std::endl;
+        return 2;
+    }
+
+    if (engineNames.empty()) {
+        engineNames = {"bytecode",
+#ifdef WASMINT_NATIVE_JIT
+                       "native",
+#endif
+                       "at",
+#ifdef WASMINT_BENCH_WASM2C
+                       "wasm2c",
+#endif
+        };
+    }
+
+    std::vector<std::unique_ptr<BenchmarkEngine>> engines;
+    for (const std::string& name : engineNames) {
+        engines.push_back(createEngine(name, history));
+        if (!engines.back()) {
+            std::cerr << "Unknown engine " << name << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+
+    std::vector<BenchmarkWorkload> workloads;
+    for (const BenchmarkWorkload& workload : standardWorkloads()) {
+        if (workloadNames.empty()
+            || std::find(workloadNames.begin(), workloadNames.end(), workload.name) != workloadNames.end()) {
+            workloads.push_back(workload);
+        }
+    }
+    if (workloads.size() < std::max<std::size_t>(workloadNames.size(), 1)) {
+        std::cerr << "Unknown workload in the given workload names" << std::endl;
+        return 2;
+    }
+
+    std::vector<BenchmarkResult> results;
+    try {
+        for (const BenchmarkWorkload& workload : workloads) {
+            for (std::unique_ptr<BenchmarkEngine>& engine : engines) {
+                results.push_back(runner.run(*engine, workload));
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    runner.print(std::cout, results);
+
+    if (!jsonPath.empty()) {
+        std::ofstream jsonFile(jsonPath);
+        runner.writeJson(jsonFile, results);
+        if (!jsonFile) {
+            std::cerr << "Can't write results to " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+}
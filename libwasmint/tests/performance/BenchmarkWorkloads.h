@@ -0,0 +1,140 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef WASMINT_BENCHMARKWORKLOADS_H
+#define WASMINT_BENCHMARKWORKLOADS_H
+
+#include "Benchmark.h"
+
+namespace wasmint {
+
+    /**
+     * The workloads wasmint_bench runs by default. Each $main returns a checksum of its work, so
+     * an engine that computes something else fails the benchmark instead of getting faster.
+     */
+    inline std::vector<BenchmarkWorkload> standardWorkloads() {
+        return {
+            // recursive calls with little work in between
+            BenchmarkWorkload("fib",
+                "module "
+                "(func $fib (param $n i32) (result i32) "
+                "  (if (i32.lt_u (get_local $n) (i32.const 2)) (return (get_local $n))) "
+                "  (i32.add (call $fib (i32.sub (get_local $n) (i32.const 1))) "
+                "           (call $fib (i32.sub (get_local $n) (i32.const 2))))) "
+                "(func $main (result i32) (call $fib (i32.const 22)))",
+                17711),
+
+            // byte loads and stores with data dependent branches
+            BenchmarkWorkload("quicksort",
+                "module (memory 1 1) "
+                "(func $fill (param $length i32) (local $i i32) (local $seed i32) "
+                "  (set_local $seed (i32.const 42)) "
+                "  (loop $exit $cont "
+                "    (set_local $seed (i32.add (i32.mul (get_local $seed) (i32.const 1103515245)) (i32.const 12345))) "
+                "    (i32.store8 (get_local $i) (i32.shr_u (get_local $seed) (i32.const 16))) "
+                "    (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "    (br_if $cont (i32.lt_u (get_local $i) (get_local $length))))) "
+                "(func $swap (param $a i32) (param $b i32) (local $tmp i32) "
+                "  (set_local $tmp (i32.load8_u (get_local $a))) "
+                "  (i32.store8 (get_local $a) (i32.load8_u (get_local $b))) "
+                "  (i32.store8 (get_local $b) (get_local $tmp))) "
+                "(func $quicksort (param $begin i32) (param $end i32) (local $i i32) (local $split i32) "
+                "  (if (i32.gt_u (i32.sub (get_local $end) (get_local $begin)) (i32.const 1)) (block "
+                "    (set_local $i (get_local $begin)) "
+                "    (set_local $split (get_local $begin)) "
+                "    (loop $exit $cont "
+                "      (if (i32.lt_u (i32.load8_u (get_local $i)) (i32.load8_u (i32.sub (get_local $end) (i32.const 1)))) "
+                "        (block "
+                "          (call $swap (get_local $i) (get_local $split)) "
+                "          (set_local $split (i32.add (get_local $split) (i32.const 1))))) "
+                "      (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "      (br_if $cont (i32.lt_u (get_local $i) (i32.sub (get_local $end) (i32.const 1))))) "
+                "    (call $swap (get_local $split) (i32.sub (get_local $end) (i32.const 1))) "
+                "    (call $quicksort (get_local $begin) (get_local $split)) "
+                "    (call $quicksort (i32.add (get_local $split) (i32.const 1)) (get_local $end))))) "
+                "(func $main (result i32) (local $i i32) (local $hash i32) "
+                "  (call $fill (i32.const 8192)) "
+                "  (call $quicksort (i32.const 0) (i32.const 8192)) "
+                "  (loop $exit $cont "
+                "    (set_local $hash (i32.add (i32.mul (get_local $hash) (i32.const 31)) (i32.load8_u (get_local $i)))) "
+                "    (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "    (br_if $cont (i32.lt_u (get_local $i) (i32.const 8192)))) "
+                "  (get_local $hash))",
+                1094795937),
+
+            // a tight loop over the heap
+            BenchmarkWorkload("vector_sum",
+                "module (memory 1 1) "
+                "(func $main (result i32) (local $i i32) (local $round i32) (local $sum i32) "
+                "  (loop $exit $cont "
+                "    (i32.store8 (get_local $i) (i32.mul (get_local $i) (i32.const 7))) "
+                "    (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "    (br_if $cont (i32.lt_u (get_local $i) (i32.const 65536)))) "
+                "  (loop $roundsExit $rounds "
+                "    (set_local $i (i32.const 0)) "
+                "    (loop $exit $cont "
+                "      (set_local $sum (i32.add (get_local $sum) (i32.load8_u (get_local $i)))) "
+                "      (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "      (br_if $cont (i32.lt_u (get_local $i) (i32.const 65536)))) "
+                "    (set_local $round (i32.add (get_local $round) (i32.const 1))) "
+                "    (br_if $rounds (i32.lt_u (get_local $round) (i32.const 4)))) "
+                "  (get_local $sum))",
+                33423360),
+
+            // floating point arithmetic and 64 bit loads and stores
+            BenchmarkWorkload("matrix_f64",
+                "module (memory 1 1) "
+                "(func $main (result i32) (local $i i32) (local $j i32) (local $k i32) (local $sum f64) (local $total f64) "
+                // A is at 0, B at 12800 and C at 25600, all 40x40
+                "  (loop $iExit $iCont "
+                "    (set_local $j (i32.const 0)) "
+                "    (loop $jExit $jCont "
+                "      (f64.store (i32.mul (i32.add (i32.mul (get_local $i) (i32.const 40)) (get_local $j)) (i32.const 8)) "
+                "                 (f64.convert_s/i32 (i32.add (get_local $i) (get_local $j)))) "
+                "      (f64.store (i32.add (i32.const 12800) (i32.mul (i32.add (i32.mul (get_local $i) (i32.const 40)) (get_local $j)) (i32.const 8))) "
+                "                 (f64.div (f64.convert_s/i32 (i32.sub (get_local $i) (get_local $j))) (f64.const 4))) "
+                "      (set_local $j (i32.add (get_local $j) (i32.const 1))) "
+                "      (br_if $jCont (i32.lt_u (get_local $j) (i32.const 40)))) "
+                "    (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "    (br_if $iCont (i32.lt_u (get_local $i) (i32.const 40)))) "
+                "  (set_local $i (i32.const 0)) "
+                "  (loop $iExit $iCont "
+                "    (set_local $j (i32.const 0)) "
+                "    (loop $jExit $jCont "
+                "      (set_local $sum (f64.const 0)) "
+                "      (set_local $k (i32.const 0)) "
+                "      (loop $kExit $kCont "
+                "        (set_local $sum (f64.add (get_local $sum) (f64.mul "
+                "          (f64.load (i32.mul (i32.add (i32.mul (get_local $i) (i32.const 40)) (get_local $k)) (i32.const 8))) "
+                "          (f64.load (i32.add (i32.const 12800) (i32.mul (i32.add (i32.mul (get_local $k) (i32.const 40)) (get_local $j)) (i32.const 8))))))) "
+                "        (set_local $k (i32.add (get_local $k) (i32.const 1))) "
+                "        (br_if $kCont (i32.lt_u (get_local $k) (i32.const 40)))) "
+                "      (f64.store (i32.add (i32.const 25600) (i32.mul (i32.add (i32.mul (get_local $i) (i32.const 40)) (get_local $j)) (i32.const 8))) "
+                "                 (get_local $sum)) "
+                "      (set_local $total (f64.add (get_local $total) (get_local $sum))) "
+                "      (set_local $j (i32.add (get_local $j) (i32.const 1))) "
+                "      (br_if $jCont (i32.lt_u (get_local $j) (i32.const 40)))) "
+                "    (set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "    (br_if $iCont (i32.lt_u (get_local $i) (i32.const 40)))) "
+                "  (i32.trunc_s/f64 (get_local $total)))",
+                2132000)
+        };
+    }
+}
+
+#endif //WASMINT_BENCHMARKWORKLOADS_H
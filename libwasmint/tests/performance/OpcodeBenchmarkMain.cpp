@@ -0,0 +1,133 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "OpcodeBenchmarks.h"
+
+using namespace wasmint;
+
+void printUsage() {
+    std::cerr << "Usage: wasmint_opbench [--iterations N] [--warmup N] [--repetitions N] [--opcode NAME]... "
+                 "[--engine NAME] [--json FILE]\n"
+                 "Engines: bytecode"
+#ifdef WASMINT_NATIVE_JIT
+                 ", native"
+#endif
+                 ", at\n"
+                 "Opcode names are the ones of ByteOpcodes::name, e.g. I32Add"
+              << std::endl;
+}
+
+std::unique_ptr<BenchmarkEngine> createEngine(const std::string& name) {
+    if (name == "bytecode")
+        return std::unique_ptr<BenchmarkEngine>(new VMBenchmarkEngine(false));
+#ifdef WASMINT_NATIVE_JIT
+    if (name == "native")
+        return std::unique_ptr<BenchmarkEngine>(new VMBenchmarkEngine(true));
+#endif
+    if (name == "at")
+        return std::unique_ptr<BenchmarkEngine>(new ATBenchmarkEngine());
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner;
+    runner.warmup(1);
+    runner.repetitions(5);
+    OpcodeBenchmarkSuite suite;
+    std::vector<std::string> opcodeNames;
+    std::string engineName = "bytecode";
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            suite.iterations((std::size_t) std::stoul(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            runner.warmup((std::size_t) std::stoul(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            runner.repetitions((std::size_t) std::stoul(argv[++i]));
+        } else if (arg == "--opcode" && i + 1 < argc) {
+            opcodeNames.push_back(argv[++i]);
+        } else if (arg == "--engine" && i + 1 < argc) {
+            engineName = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+
+    if (runner.repetitions() == 0 || suite.iterations() == 0) {
+        std::cerr << "At least one repetition and iteration is needed" << std::endl;
+        return 2;
+    }
+
+    std::unique_ptr<BenchmarkEngine> engine = createEngine(engineName);
+    if (!engine) {
+        std::cerr << "Unknown engine " << engineName << std::endl;
+        printUsage();
+        return 2;
+    }
+
+    std::vector<OpcodeBenchmark> benchmarks;
+    for (const OpcodeBenchmark& benchmark : OpcodeBenchmarkSuite::benchmarks()) {
+        const std::string name = ByteOpcodes::name(benchmark.opcode);
+        if (opcodeNames.empty() || std::find(opcodeNames.begin(), opcodeNames.end(), name) != opcodeNames.end()) {
+            benchmarks.push_back(benchmark);
+        }
+    }
+    if (benchmarks.size() < std::max<std::size_t>(opcodeNames.size(), 1)) {
+        std::cerr << "Unknown opcode in the given opcode names" << std::endl;
+        return 2;
+    }
+
+    std::vector<OpcodeBenchmarkResult> results;
+    try {
+#ifdef WASMINT_OPCODE_STATS
+        // counting opcodes slows down every instruction, so the timings of this build are only
+        // useful to compare opcodes with each other
+        for (const OpcodeBenchmark& benchmark : benchmarks) {
+            suite.verify(benchmark);
+        }
+#endif
+        results = suite.run(runner, *engine, benchmarks);
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    suite.print(std::cout, results);
+
+    if (!jsonPath.empty()) {
+        std::ofstream jsonFile(jsonPath);
+        suite.writeJson(jsonFile, results);
+        if (!jsonFile) {
+            std::cerr << "Can't write results to " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "OpcodeBenchmarks.h"
+
+#include <algorithm>
+#include <iomanip>
+#ifdef WASMINT_OPCODE_STATS
+#include <interpreter/WasmintVM.h>
+#endif
+
+namespace wasmint {
+
+    namespace {
+        const std::string baselineStatement = "(set_local $r_i32 (get_local $a_i32))";
+
+        // instructions the baseline statement executes
+        const double baselineInstructions = 2;
+
+        std::string binary(const std::string& type, const std::string& op, const std::string& resultType) {
+            return "(set_local $r_" + resultType + " (" + type + "." + op + " (get_local $a_" + type + ")"
+                   " (get_local $b_" + type + ")))";
+        }
+
+        std::string unary(const std::string& type, const std::string& op, const std::string& resultType) {
+            return "(set_local $r_" + resultType + " (" + type + "." + op + " (get_local $a_" + type + ")))";
+        }
+
+        // adds one benchmark per name, starting at the given opcode in the order of ByteOpcodes
+        void addIntegerOperations(std::vector<OpcodeBenchmark>& benchmarks, ByteOpcodes::Values first,
+                                  const std::string& type) {
+            const std::vector<std::string> binaryOperations = {
+                    "add", "sub", "mul", "div_s", "div_u", "rem_s", "rem_u", "and", "or", "xor", "shl", "shr_u", "shr_s"
+            };
+            const std::vector<std::string> comparisons = {
+                    "eq", "ne", "lt_s", "le_s", "lt_u", "le_u", "gt_s", "ge_s", "gt_u", "ge_u"
+            };
+            const std::vector<std::string> unaryOperations = {"clz", "ctz", "popcnt"};
+
+            int opcode = first;
+            for (const std::string& op : binaryOperations)
+                benchmarks.emplace_back((ByteOpcodes::Values) opcode++, binary(type, op, type));
+            benchmarks.emplace_back((ByteOpcodes::Values) opcode++, unary(type, "eqz", "i32"));
+            for (const std::string& op : comparisons)
+                benchmarks.emplace_back((ByteOpcodes::Values) opcode++, binary(type, op, "i32"));
+            for (const std::string& op : unaryOperations)
+                benchmarks.emplace_back((ByteOpcodes::Values) opcode++, unary(type, op, type));
+        }
+
+        void addFloatOperations(std::vector<OpcodeBenchmark>& benchmarks, ByteOpcodes::Values first,
+                                const std::string& type) {
+            const std::vector<std::string> names = {
+                    "add", "sub", "mul", "div", "abs", "neg", "copysign", "ceil", "floor", "trunc", "nearest",
+                    "eq", "ne", "lt", "le", "gt", "ge", "sqrt", "min", "max"
+            };
+            const std::vector<std::string> unaryOperations = {"abs", "neg", "ceil", "floor", "trunc", "nearest", "sqrt"};
+            const std::vector<std::string> comparisons = {"eq", "ne", "lt", "le", "gt", "ge"};
+
+            int opcode = first;
+            for (const std::string& op : names) {
+                std::string statement;
+                if (std::find(unaryOperations.begin(), unaryOperations.end(), op) != unaryOperations.end())
+                    statement = unary(type, op, type);
+                else if (std::find(comparisons.begin(), comparisons.end(), op) != comparisons.end())
+                    statement = binary(type, op, "i32");
+                else
+                    statement = binary(type, op, type);
+                benchmarks.emplace_back((ByteOpcodes::Values) opcode++, statement);
+            }
+        }
+    }
+
+    std::vector<OpcodeBenchmark> OpcodeBenchmarkSuite::benchmarks() {
+        std::vector<OpcodeBenchmark> result;
+
+        addIntegerOperations(result, ByteOpcodes::I32Add, "i32");
+        addIntegerOperations(result, ByteOpcodes::I64Add, "i64");
+
+        result.emplace_back(ByteOpcodes::I32Const, "(set_local $r_i32 (i32.const 7))");
+        result.emplace_back(ByteOpcodes::I64Const, "(set_local $r_i64 (i64.const 7))");
+        result.emplace_back(ByteOpcodes::F32Const, "(set_local $r_f32 (f32.const 7.5))");
+        result.emplace_back(ByteOpcodes::F64Const, "(set_local $r_f64 (f64.const 7.5))");
+
+        result.emplace_back(ByteOpcodes::CallIndirect, "(set_local $r_i32 (call_indirect $constType (get_local $zero)))");
+        result.emplace_back(ByteOpcodes::Call, "(set_local $r_i32 (call $one))");
+        result.emplace_back(ByteOpcodes::Branch, "(block $b (br $b))");
+        // the condition is zero, so neither of them branches
+        result.emplace_back(ByteOpcodes::BranchIf, "(block $b (br_if $b (get_local $zero)))");
+        result.emplace_back(ByteOpcodes::BranchIfNot, "(if (get_local $a_i32) (nop))");
+        result.emplace_back(ByteOpcodes::GetLocal, baselineStatement);
+        result.emplace_back(ByteOpcodes::SetLocal, baselineStatement);
+        result.emplace_back(ByteOpcodes::TeeLocal, "(set_local $r_i32 (tee_local $t_i32 (get_local $a_i32)))");
+        result.emplace_back(ByteOpcodes::Drop, "(drop (get_local $a_i32))");
+        result.emplace_back(ByteOpcodes::GrowMemory, "(set_local $r_i32 (grow_memory (get_local $zero)))");
+        result.emplace_back(ByteOpcodes::PageSize, "(set_local $r_i32 (page_size))");
+        result.emplace_back(ByteOpcodes::CurrentMemory, "(set_local $r_i32 (current_memory))");
+
+        const std::vector<std::string> loads = {
+                "i32.load8_s", "i32.load8_u", "i32.load16_s", "i32.load16_u", "i32.load",
+                "i64.load8_s", "i64.load8_u", "i64.load16_s", "i64.load16_u", "i64.load32_s", "i64.load32_u", "i64.load",
+                "f32.load", "f64.load"
+        };
+        int opcode = ByteOpcodes::I32Load8Signed;
+        for (const std::string& load : loads) {
+            result.emplace_back((ByteOpcodes::Values) opcode++,
+                                "(set_local $r_" + load.substr(0, 3) + " (" + load + " (get_local $zero)))");
+        }
+
+        const std::vector<std::string> stores = {
+                "i32.store8", "i32.store16", "i32.store",
+                "i64.store8", "i64.store16", "i64.store32", "i64.store",
+                "f32.store", "f64.store"
+        };
+        opcode = ByteOpcodes::I32Store8;
+        for (const std::string& store : stores) {
+            result.emplace_back((ByteOpcodes::Values) opcode++,
+                                "(" + store + " (get_local $zero) (get_local $a_" + store.substr(0, 3) + "))");
+        }
+
+        // the result type is in front of the dot, the operand type after the slash
+        const std::vector<std::string> conversions = {
+                "i32.wrap/i64", "i32.trunc_s/f32", "i32.trunc_s/f64", "i32.trunc_u/f32", "i32.trunc_u/f64",
+                "i64.extend_s/i32", "i64.extend_u/i32", "i64.trunc_s/f32", "i64.trunc_s/f64", "i64.trunc_u/f32",
+                "i64.trunc_u/f64", "f32.demote/f64", "f32.convert_s/i32", "f32.convert_s/i64", "f32.convert_u/i32",
+                "f32.convert_u/i64", "f64.promote/f32", "f64.convert_s/i32", "f64.convert_s/i64", "f64.convert_u/i32",
+                "f64.convert_u/i64"
+        };
+        opcode = ByteOpcodes::I32Wrap;
+        for (const std::string& conversion : conversions) {
+            std::string resultType = conversion.substr(0, 3);
+            std::string operandType = conversion.substr(conversion.find('/') + 1);
+            result.emplace_back((ByteOpcodes::Values) opcode++,
+                                "(set_local $r_" + resultType + " (" + conversion + " (get_local $a_" + operandType + ")))");
+        }
+
+        opcode = ByteOpcodes::I32Select;
+        for (const std::string type : {"i32", "i64", "f32", "f64"}) {
+            result.emplace_back((ByteOpcodes::Values) opcode++,
+                                "(set_local $r_" + type + " (select (get_local $a_" + type + ") (get_local $b_" + type
+                                + ") (get_local $a_i32)))");
+        }
+
+        addFloatOperations(result, ByteOpcodes::F32Add, "f32");
+        addFloatOperations(result, ByteOpcodes::F64Add, "f64");
+
+        result.emplace_back(ByteOpcodes::Nop, "(nop)");
+        return result;
+    }
+
+    BenchmarkWorkload OpcodeBenchmarkSuite::workload(const std::string& name, const std::string& statement) const {
+        std::string body;
+        for (std::size_t i = 0; i < unrolled; i++) {
+            body += statement + " ";
+        }
+
+        // the operands are chosen so that no operation traps: divisors are non-zero and the float
+        // values fit into every integer type they are truncated to
+        std::string source =
+                "module (memory 1 1) "
+                "(type $constType (func (result i32))) "
+                "(func $one (type $constType) (result i32) (i32.const 1)) "
+                "(func $main (result i32) "
+                "(local $i i32) (local $zero i32) (local $t_i32 i32) "
+                "(local $a_i32 i32) (local $b_i32 i32) (local $r_i32 i32) "
+                "(local $a_i64 i64) (local $b_i64 i64) (local $r_i64 i64) "
+                "(local $a_f32 f32) (local $b_f32 f32) (local $r_f32 f32) "
+                "(local $a_f64 f64) (local $b_f64 f64) (local $r_f64 f64) "
+                "(set_local $a_i32 (i32.const 1234567)) (set_local $b_i32 (i32.const 3)) "
+                "(set_local $a_i64 (i64.const 123456789012)) (set_local $b_i64 (i64.const 3)) "
+                "(set_local $a_f32 (f32.const 1234.5)) (set_local $b_f32 (f32.const 3.25)) "
+                "(set_local $a_f64 (f64.const 1234.5)) (set_local $b_f64 (f64.const 3.25)) "
+                "(loop $exit $continue " + body +
+                "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "(br_if $continue (i32.lt_u (get_local $i) (i32.const " + std::to_string(iterations_) + ")))) "
+                "(i32.const 0)) "
+                "(table $one)";
+        return BenchmarkWorkload(name, source, 0);
+    }
+
+    std::vector<OpcodeBenchmarkResult> OpcodeBenchmarkSuite::run(BenchmarkRunner& runner, BenchmarkEngine& engine,
+                                                                 const std::vector<OpcodeBenchmark>& benchmarks) {
+        baseline_ = runner.run(engine, workload("baseline", baselineStatement));
+
+        const double statements = (double) iterations_ * unrolled;
+        const double dispatch = dispatchNanoseconds();
+
+        std::vector<OpcodeBenchmarkResult> results;
+        for (const OpcodeBenchmark& benchmark : benchmarks) {
+            OpcodeBenchmarkResult result;
+            result.opcode = benchmark.opcode;
+            result.measurement = runner.run(engine, workload(ByteOpcodes::name(benchmark.opcode), benchmark.statement));
+
+            double additionalInstructions = ((double) result.measurement.instructions - baseline_.instructions) / statements;
+            result.instructionsPerStatement = baselineInstructions + additionalInstructions;
+
+            // everything the statement executes besides the opcode itself is charged with the
+            // dispatch time of the baseline
+            double additionalTime = (result.measurement.statistics.min - baseline_.statistics.min) / statements;
+            result.nanosecondsPerOperation = additionalTime + baselineInstructions * dispatch
+                                             - (result.instructionsPerStatement - 1) * dispatch;
+            results.push_back(result);
+        }
+        return results;
+    }
+
+#ifdef WASMINT_OPCODE_STATS
+    void OpcodeBenchmarkSuite::verify(const OpcodeBenchmark& benchmark) const {
+        BenchmarkWorkload verified = workload(ByteOpcodes::name(benchmark.opcode), benchmark.statement);
+        WasmintVM vm;
+        vm.nativeExecution(false);
+        vm.loadModuleFromData(verified.source);
+        vm.startAtFunction(*vm.modules().front()->function("$main"), false);
+        vm.stepUntilFinished();
+
+        if (vm.gotTrap())
+            throw BenchmarkFailed(verified.name + " trapped: " + vm.trapReason());
+        if (vm.opcodeStatistics().opcodeCount(benchmark.opcode) < iterations_ * unrolled)
+            throw BenchmarkFailed(verified.name + " executes its opcode only "
+                                  + std::to_string(vm.opcodeStatistics().opcodeCount(benchmark.opcode)) + " times");
+    }
+#endif
+
+    double OpcodeBenchmarkSuite::dispatchNanoseconds() const {
+        if (baseline_.instructions == 0)
+            return 0;
+        return baseline_.statistics.min / baseline_.instructions;
+    }
+
+    void OpcodeBenchmarkSuite::print(std::ostream& output, const std::vector<OpcodeBenchmarkResult>& results) const {
+        output << std::fixed << std::setprecision(2);
+        output << "engine " << baseline_.engine << ", " << iterations_ * unrolled << " statements per opcode, "
+               << dispatchNanoseconds() << " ns dispatch per instruction\n";
+        output << std::left << std::setw(24) << "opcode"
+               << std::right << std::setw(14) << "instr/stmt" << std::setw(12) << "ns/op"
+               << std::setw(20) << "ns over dispatch" << "\n";
+        for (const OpcodeBenchmarkResult& result : results) {
+            output << std::left << std::setw(24) << ByteOpcodes::name(result.opcode)
+                   << std::right << std::setw(14) << result.instructionsPerStatement
+                   << std::setw(12) << result.nanosecondsPerOperation
+                   << std::setw(20) << result.nanosecondsPerOperation - dispatchNanoseconds() << "\n";
+        }
+    }
+
+    void OpcodeBenchmarkSuite::writeJson(std::ostream& output, const std::vector<OpcodeBenchmarkResult>& results) const {
+        output << std::fixed << std::setprecision(3);
+        output << "{\n  \"engine\": \"" << baseline_.engine << "\",\n  \"iterations\": " << iterations_
+               << ",\n  \"unrolled\": " << unrolled
+               << ",\n  \"baseline_min_ns\": " << baseline_.statistics.min
+               << ",\n  \"dispatch_ns\": " << dispatchNanoseconds() << ",\n  \"opcodes\": [";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const OpcodeBenchmarkResult& result = results[i];
+            output << (i == 0 ? "\n" : ",\n")
+                   << "    {\"opcode\": \"" << ByteOpcodes::name(result.opcode) << "\""
+                   << ", \"instructions_per_statement\": " << result.instructionsPerStatement
+                   << ", \"ns_per_op\": " << result.nanosecondsPerOperation
+                   << ", \"min_ns\": " << result.measurement.statistics.min
+                   << ", \"median_ns\": " << result.measurement.statistics.median
+                   << ", \"p95_ns\": " << result.measurement.statistics.p95 << "}";
+        }
+        output << "\n  ]\n}\n";
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_OPCODEBENCHMARKS_H
+#define WASMINT_OPCODEBENCHMARKS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <interpreter/ByteOpcodes.h>
+#include "Benchmark.h"
+
+namespace wasmint {
+
+    /**
+     * A statement that makes the bytecode interpreter execute the given opcode once. The
+     * statement has to leave the value stack empty.
+     */
+    struct OpcodeBenchmark {
+        ByteOpcodes::Values opcode;
+        std::string statement;
+
+        OpcodeBenchmark(ByteOpcodes::Values opcode, const std::string& statement)
+                : opcode(opcode), statement(statement) {
+        }
+    };
+
+    struct OpcodeBenchmarkResult {
+        ByteOpcodes::Values opcode;
+        // bytecode instructions a single statement executes
+        double instructionsPerStatement = 0;
+        // time of the opcode itself with the dispatch of all instructions of the statement removed
+        double nanosecondsPerOperation = 0;
+        BenchmarkResult measurement;
+    };
+
+    /**
+     * Measures each opcode in a loop that repeats its statement unrolled times per iteration.
+     *
+     * The baseline is the same loop around (set_local $r_i32 (get_local $a_i32)). Its time per
+     * instruction is the dispatch overhead of the interpreter. The cost of an opcode is the time
+     * its loop takes longer than the baseline, minus the dispatch of the additional instructions
+     * that load the operands and store the result. All times are taken from the fastest run,
+     * which is less disturbed by other processes than the median.
+     */
+    class OpcodeBenchmarkSuite {
+        std::size_t iterations_ = 20000;
+        BenchmarkResult baseline_;
+
+    public:
+        static const std::size_t unrolled = 16;
+
+        /**
+         * All opcodes the suite can measure. Opcodes that trap, are only used internally by the
+         * interpreter or need imported functions are left out.
+         */
+        static std::vector<OpcodeBenchmark> benchmarks();
+
+        BenchmarkWorkload workload(const std::string& name, const std::string& statement) const;
+
+        /**
+         * Measures the baseline and then every benchmark with the given engine.
+         */
+        std::vector<OpcodeBenchmarkResult> run(BenchmarkRunner& runner, BenchmarkEngine& engine,
+                                               const std::vector<OpcodeBenchmark>& benchmarks);
+
+#ifdef WASMINT_OPCODE_STATS
+        /**
+         * Throws BenchmarkFailed if the statement of the benchmark doesn't execute its opcode
+         * at least once per repetition.
+         */
+        void verify(const OpcodeBenchmark& benchmark) const;
+#endif
+
+        /**
+         * Nanoseconds the interpreter spends per instruction in the fastest run of the baseline.
+         */
+        double dispatchNanoseconds() const;
+
+        std::size_t iterations() const {
+            return iterations_;
+        }
+
+        void iterations(std::size_t iterations) {
+            iterations_ = iterations;
+        }
+
+        const BenchmarkResult& baseline() const {
+            return baseline_;
+        }
+
+        void print(std::ostream& output, const std::vector<OpcodeBenchmarkResult>& results) const;
+
+        void writeJson(std::ostream& output, const std::vector<OpcodeBenchmarkResult>& results) const;
+    };
+}
+
+#endif //WASMINT_OPCODEBENCHMARKS_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <cstdint>
+#include <sstream>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/profiling/Profiler.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// $hot runs a loop of 1000 iterations while $cold only adds two numbers
+const std::string source = "module "
+        "(func $cold (param $a i32) (result i32) (i32.add (get_local $a) (i32.const 1))) "
+        "(func $hot (param $a i32) (result i32) (local $i i32) "
+        "(loop $exit $cont "
+        "(set_local $a (i32.mul (get_local $a) (i32.const 3))) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 1000)))) "
+        "(get_local $a)) "
+        "(func $main (result i32) (local $i i32) (local $sum i32) "
+        "(loop $exit $cont "
+        "(set_local $sum (i32.add (call $hot (get_local $i)) (call $cold (get_local $sum)))) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100)))) "
+        "(get_local $sum))";
+
+std::string profile(uint64_t interval, InstructionCounter& counter, Profiler*& result, Module*& module, WasmintVM& vm) {
+    module = ModuleParser::parse(source);
+    vm.loadModule(*module, true);
+    vm.startAtFunction(*module->function("$main"));
+    result = new Profiler(vm);
+    result->interval(interval);
+    result->run();
+    counter = vm.instructionCounter();
+    std::stringstream folded;
+    result->writeFoldedStacks(folded);
+    return folded.str();
+}
+
+int main() {
+    WasmintVM vm;
+    assert(vm.nativeExecution());
+    InstructionCounter counter;
+    Profiler* profiler;
+    Module* module;
+    std::string folded = profile(97, counter, profiler, module, vm);
+    assert(vm.nativeExecution());
+    assert(vm.finished());
+
+    // one sample per interval with the thread still running
+    assert(profiler->sampleCount() == counter.toUint64() / 97);
+
+    const Function& hot = *module->function("$hot");
+    const Function& cold = *module->function("$cold");
+    const Function& main = *module->function("$main");
+    assert(profiler->samples(hot) > 50 * (profiler->samples(cold) + profiler->samples(main)));
+    assert(profiler->samples(hot) + profiler->samples(cold) + profiler->samples(main) == profiler->sampleCount());
+
+    uint64_t instructionSamples = 0;
+    for (const auto& entry : profiler->instructionSamples()) {
+        instructionSamples += entry.second;
+    }
+    assert(instructionSamples == profiler->sampleCount());
+    assert(profiler->samples(*hot.mainInstruction()) < profiler->sampleCount());
+
+    // flamegraph tools expect one "frame;frame;frame count" line per stack
+    std::stringstream lines(folded);
+    std::string line;
+    uint64_t foldedSamples = 0;
+    bool sawHotLoop = false;
+    while (std::getline(lines, line)) {
+        std::size_t space = line.rfind(' ');
+        assert(space != std::string::npos);
+        foldedSamples += std::stoull(line.substr(space + 1));
+        if (line.find("$main;$hot;i32.") == 0)
+            sawHotLoop = true;
+        assert(line.find("$cold;$") == std::string::npos);
+    }
+    assert(foldedSamples == profiler->sampleCount());
+    assert(sawHotLoop);
+
+    // the interval is counted in instructions, so profiles are reproducible
+    WasmintVM otherVm;
+    Profiler* otherProfiler;
+    Module* otherModule;
+    InstructionCounter otherCounter;
+    assert(profile(97, otherCounter, otherProfiler, otherModule, otherVm) == folded);
+    assert(otherCounter == counter);
+
+    delete profiler;
+    delete otherProfiler;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <cstdint>
+#include <sstream>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+#include <interpreter/profiling/Tracer.h>
+#include <tests/TestHelpers.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+// $main calls $step 100 times and $step calls host.double once
+const std::string source = "module (import $double \"host\" \"double\" (param i32) (result i32)) "
+        "(func $step (param $a i32) (result i32) (call_import $double (get_local $a))) "
+        "(func $main (result i32) (local $i i32) (local $sum i32) "
+        "(loop $exit $cont "
+        "(set_local $sum (i32.add (get_local $sum) (call $step (get_local $i)))) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 100)))) "
+        "(get_local $sum))";
+
+std::size_t count(const std::string& text, const std::string& pattern) {
+    std::size_t result = 0;
+    for (std::size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        result++;
+    }
+    return result;
+}
+
+std::string trace(Tracer& tracer, bool history = false) {
+    WasmintVM vm;
+    vm.loadModule(*createDoublingHostModule(), true);
+    Module* module = ModuleParser::parse(source);
+    vm.loadModule(*module, true);
+    vm.tracer(&tracer);
+    vm.startAtFunction(*module->function("$main"), history);
+    vm.stepUntilFinished();
+    assert(vm.state().thread().result().int32() == 9900);
+    if (history) {
+        // replaying the history doesn't call the functions again
+        std::size_t events = tracer.eventCount();
+        InstructionCounter end = vm.instructionCounter();
+        vm.simulateTo(end - 50);
+        vm.simulateTo(end);
+        assert(tracer.eventCount() == events);
+    }
+    std::stringstream output;
+    tracer.writeChromeTrace(output);
+    return output.str();
+}
+
+int main() {
+    {
+        Tracer tracer;
+        std::string json = trace(tracer);
+        assert(tracer.eventCount() == 2 * (1 + 100 + 100));
+        assert(json.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n{\"name\": \"$main\", \"cat\": ") == 0);
+        assert(count(json, "\"ph\": \"B\"") == 201);
+        assert(count(json, "\"ph\": \"E\"") == 201);
+        assert(count(json, "\"name\": \"double\", \"cat\": \"host\"") == 200);
+    }
+    {
+        Tracer tracer;
+        tracer.traceFunction("$step");
+        tracer.sampleInterval(10);
+        std::string json = trace(tracer, true);
+        assert(tracer.eventCount() == 2 * 10);
+        assert(count(json, "\"name\": \"$step\"") == 20);
+    }
+    {
+        Tracer tracer;
+        tracer.traceModule("host");
+        trace(tracer);
+        assert(tracer.eventCount() == 2 * 100);
+    }
+    {
+        // the oldest events are overwritten, and exits without their entry are left out
+        Tracer tracer(51);
+        std::string json = trace(tracer);
+        assert(tracer.overflowed());
+        assert(tracer.eventCount() == 51);
+        std::size_t entries = count(json, "\"ph\": \"B\"");
+        std::size_t exits = count(json, "\"ph\": \"E\"");
+        assert(entries + exits < 51);
+        assert(exits <= entries);
+    }
+}
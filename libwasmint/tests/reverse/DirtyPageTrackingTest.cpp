@@ -0,0 +1,101 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstdint>
+#include <map>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+const char* source = "module (memory 1 1) "
+        "(func $fill (param $n i32) "
+            "(if (get_local $n) (block "
+                "(i32.store (i32.mul (get_local $n) (i32.const 4000)) (i32.add (i32.load (i32.const 0)) (get_local $n))) "
+                "(call $fill (i32.sub (get_local $n) (i32.const 1))))))"
+        "(func $main (result i32) (local $i i32) "
+            "(loop $exit $cont "
+                "(i32.store (i32.const 0) (get_local $i)) "
+                "(call $fill (i32.const 16)) "
+                "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+                "(br_if $cont (i32.lt_u (get_local $i) (i32.const 30)))) "
+            "(i32.load (i32.const 4000)))";
+
+int main() {
+    if (!DirtyPageTracker::supported())
+        return 0;
+    {
+        // the states restored from the protected pages are the same as with the observer
+        WasmintVM vm;
+        vm.history().dirtyPageTracking(true);
+        vm.history().automaticCheckpoints(50, 1024 * 1024);
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->function("$main"));
+        assert(vm.history().heapPatchChunkSize() == systemPageSize());
+
+        std::map<InstructionCounter, VMState> states;
+        VMState startState = vm.state();
+        while (!vm.finished()) {
+            vm.step();
+            if (vm.instructionCounter().multipleOf(31) && !vm.finished()) {
+                states[vm.instructionCounter()] = vm.state();
+            }
+        }
+        VMState endState = vm.state();
+        assert(endState.thread().result().int32() == 29 + 1);
+        assert(vm.history().numberOfCheckpoints() > 2);
+
+        for (auto iter = states.rbegin(); iter != states.rend(); ++iter) {
+            vm.simulateTo(iter->first);
+            assert(vm.state() == iter->second);
+        }
+        vm.simulateTo(0);
+        assert(vm.state() == startState);
+        vm.simulateTo(endState.instructionCounter());
+        assert(vm.state() == endState);
+    }
+    {
+        // only the first store to a page after a checkpoint is recorded
+        WasmintVM vm;
+        vm.history().dirtyPageTracking(true);
+        vm.history().automaticCheckpoints(0, 1024 * 1024);
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.startAtFunction(*module->function("$main"));
+        VMState startState = vm.state();
+
+        vm.stepUntilFinished();
+        assert(vm.state().thread().result().int32() == 29 + 1);
+        assert(vm.history().numberOfCheckpoints() == 1);
+
+        std::size_t pages = (16 * 4000 + 4 + systemPageSize() - 1) / systemPageSize();
+        assert(vm.history().getCheckpoint(0).heapPatch().modifiedChunks().size() <= pages);
+
+        // the heap is writable while the history is restored and protected again afterwards
+        vm.simulateTo(0);
+        assert(vm.state() == startState);
+        vm.simulateTo(1000);
+        vm.heap().set<uint32_t>(8, 5);
+        vm.simulateTo(0);
+        assert(vm.state() == startState);
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <interpreter/WasmintVM.h>
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+using namespace wasmint;
+
+const std::string journalPath = "JournalTest.journal";
+
+uint32_t hostCalls = 0;
+
+// returns a different sequence in every run, like a clock or a network socket would
+Module* createHostModule(int32_t seed) {
+    Module* module = new Module();
+    module->context().name("host");
+    module->addTypedFunction<int32_t(int32_t)>("input", [=](int32_t value) {
+        hostCalls++;
+        return value * seed - (int32_t) hostCalls;
+    });
+    return module;
+}
+
+const std::string source = "module (import $input \"host\" \"input\" (param i32) (result i32)) "
+        "(func $main (result i32) (local $i i32) (local $sum i32) "
+        "(loop $exit $cont "
+        "(set_local $sum (i32.xor (get_local $sum) (call_import $input (get_local $i)))) "
+        "(set_local $i (i32.add (get_local $i) (i32.const 1))) "
+        "(br_if $cont (i32.lt_u (get_local $i) (i32.const 1000)))) "
+        "(get_local $sum))";
+
+int32_t run(int32_t seed, Journal::Mode mode, bool native, InstructionCounter& counter) {
+    WasmintVM vm;
+    vm.nativeExecution(native);
+    vm.tieringPolicy(TieringPolicy::eager());
+    vm.loadModule(*createHostModule(seed), true);
+    Module* module = ModuleParser::parse(source);
+    vm.loadModule(*module, true);
+    if (mode == Journal::Mode::Record)
+        vm.journal().record(journalPath);
+    else if (mode == Journal::Mode::Replay)
+        vm.journal().replay(journalPath);
+    vm.startAtFunction(*module->function("$main"));
+    vm.stepUntilFinished();
+    assert(!vm.gotTrap());
+    counter = vm.instructionCounter();
+    if (mode != Journal::Mode::Off)
+        assert(vm.journal().entryCount() == 1000);
+    return vm.state().thread().result().int32();
+}
+
+int main() {
+    InstructionCounter recordedCounter;
+    const int32_t recorded = run(3, Journal::Mode::Record, false, recordedCounter);
+    assert(hostCalls == 1000);
+
+    // another host returns other values, but a replay doesn't call it
+    InstructionCounter counter;
+    assert(run(5, Journal::Mode::Off, false, counter) != recorded);
+    for (bool native : {false, true}) {
+        hostCalls = 0;
+        assert(run(5, Journal::Mode::Replay, native, counter) == recorded);
+        assert(counter == recordedCounter);
+        assert(hostCalls == 0);
+    }
+
+    {
+        // a replay can be debugged with the history like a live execution
+        WasmintVM vm;
+        vm.loadModule(*createHostModule(5), true);
+        Module* module = ModuleParser::parse(source);
+        vm.loadModule(*module, true);
+        vm.journal().replay(journalPath);
+        vm.startAtFunction(*module->function("$main"), true);
+        vm.stepUntilFinished();
+        assert(vm.state().thread().result().int32() == recorded);
+        vm.simulateTo(recordedCounter - 100);
+        for (int i = 0; i < 100; i++)
+            vm.step();
+        assert(vm.state().thread().result().int32() == recorded);
+    }
+
+    {
+        std::ofstream invalid(journalPath, std::ios::binary | std::ios::trunc);
+        invalid << "no journal";
+    }
+    bool thrown = false;
+    try {
+        run(3, Journal::Mode::Replay, false, counter);
+    } catch (const InvalidJournal& e) {
+        thrown = true;
+    }
+    assert(thrown);
+    std::remove(journalPath.c_str());
+}
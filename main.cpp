@@ -11,6 +11,8 @@
 #include <builtins/StdioModule.h>
 #include <builtins/SDLModule.h>
 #include <interpreter/WasmintVM.h>
+#include <interpreter/profiling/Profiler.h>
+#include <interpreter/profiling/Tracer.h>
 #include <chrono>
 
 using namespace wasm_module;
@@ -26,6 +28,11 @@ int main(int argc, char** argv) {
     std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
     bool runMain = true;
+    bool printStats = false;
+    std::string profilePath;
+    std::string opcodeStatsPath;
+    std::string tracePath;
+    Tracer tracer;
 
     if (argc == 1) {
         std::cerr << "No modules given. Call programm like this: \n$ wasmint module1.wasm" << std::endl;
@@ -47,6 +54,41 @@ int main(int argc, char** argv) {
         if (arg.find("--") == 0) {
             if (arg == "--no-run") {
                 runMain = false;
+            } else if (arg == "--stats") {
+                printStats = true;
+            } else if (arg == "--profile" && i + 1 < argc) {
+                // the sampled call stacks are written in the folded format for flamegraph tools
+                profilePath = argv[++i];
+            } else if (arg == "--trace" && i + 1 < argc) {
+                // the function calls are written in the Chrome trace event format
+                tracePath = argv[++i];
+                vm.tracer(&tracer);
+            } else if (arg == "--trace-module" && i + 1 < argc) {
+                tracer.traceModule(argv[++i]);
+            } else if (arg == "--trace-function" && i + 1 < argc) {
+                tracer.traceFunction(argv[++i]);
+            } else if (arg == "--opcode-stats" && i + 1 < argc) {
+#ifdef WASMINT_OPCODE_STATS
+                // written as JSON if the file name ends with .json and as CSV otherwise
+                opcodeStatsPath = argv[++i];
+                // native code doesn't count its instructions
+                vm.nativeExecution(false);
+#else
+                std::cerr << "--opcode-stats requires a build with -DwasmintOpcodeStats=ON" << std::endl;
+                return 2;
+#endif
+            } else if ((arg == "--record" || arg == "--replay") && i + 1 < argc) {
+                // the return values of the native functions are written to or read from a journal
+                const std::string journalPath = argv[++i];
+                try {
+                    if (arg == "--record")
+                        vm.journal().record(journalPath);
+                    else
+                        vm.journal().replay(journalPath);
+                } catch (const std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    return 1;
+                }
             } else {
                 std::cerr << "Unknown argument " << arg << std::endl;
                 return 2;
@@ -68,19 +110,18 @@ int main(int argc, char** argv) {
 
     if (runMain) {
 
-        for (const wasm_module::Module *module : vm.modules()) {
-            try {
-                module->getFunction("$main");
-                if (mainModule != nullptr) {
-                    std::cerr << "Multiple modules with a main function! Aborting..." << std::endl;
-                    std::cerr << "Module 1 was " << module->name() << ", Module 2 was " << mainModule->name() <<
-                    std::endl;
-                    return 1;
-                }
-                mainModule = module;
-            } catch (const wasm_module::NoFunctionWithName &ex) {
-                // has no main function
+        for (const FunctionHandle& mainFunction : vm.functionsWithName("$main")) {
+            const Module* module = &mainFunction.function().module();
+            // a module can contain several functions named $main, the first one is started
+            if (module == mainModule)
+                continue;
+            if (mainModule != nullptr) {
+                std::cerr << "Multiple modules with a main function! Aborting..." << std::endl;
+                std::cerr << "Module 1 was " << module->name() << ", Module 2 was " << mainModule->name() <<
+                std::endl;
+                return 1;
             }
+            mainModule = module;
         }
 
         if (mainModule == nullptr) {
@@ -91,7 +132,43 @@ int main(int argc, char** argv) {
         try {
 
             vm.startAtFunction(*mainModule->function("$main"), false);
-            vm.stepUntilFinished();
+            if (profilePath.empty()) {
+                vm.stepUntilFinished();
+            } else {
+                Profiler profiler(vm);
+                profiler.run();
+                std::ofstream profileFile(profilePath);
+                profiler.writeFoldedStacks(profileFile);
+                if (!profileFile) {
+                    std::cerr << "Can't write profile to " << profilePath << std::endl;
+                    return 1;
+                }
+            }
+            if (!tracePath.empty()) {
+                std::ofstream traceFile(tracePath);
+                tracer.writeChromeTrace(traceFile);
+                if (!traceFile) {
+                    std::cerr << "Can't write trace to " << tracePath << std::endl;
+                    return 1;
+                }
+            }
+#ifdef WASMINT_OPCODE_STATS
+            if (!opcodeStatsPath.empty()) {
+                std::ofstream statsFile(opcodeStatsPath);
+                if (ends_with(opcodeStatsPath, ".json"))
+                    vm.opcodeStatistics().writeJson(statsFile);
+                else
+                    vm.opcodeStatistics().writeCsv(statsFile);
+                if (!statsFile) {
+                    std::cerr << "Can't write opcode statistics to " << opcodeStatsPath << std::endl;
+                    return 1;
+                }
+            }
+#endif
+            if (printStats) {
+                vm.stats().print(std::cerr);
+            }
+
             if (vm.gotTrap()) {
                 std::cerr << "Got trap while executing program: " << vm.trapReason() << std::endl;
                 return 2;
@@ -72,19 +72,18 @@ int main(int argc, char** argv) {
     }
     
 
-    for (const wasm_module::Module *module : vm.modules()) {
-        try {
-            module->getFunction("$main");
-            if (mainModule != nullptr) {
-                std::cout << "Multiple modules with a main function! Aborting..." << std::endl;
-                std::cout << "Module 1 was " << module->name() << ", Module 2 was " << mainModule->name() <<
-                std::endl;
-                return 2;
-            }
-            mainModule = module;
-        } catch (const wasm_module::NoFunctionWithName &ex) {
-            // has no main function
+    for (const FunctionHandle& mainFunction : vm.functionsWithName("$main")) {
+        const Module* module = &mainFunction.function().module();
+        // a module can contain several functions named $main, the first one is started
+        if (module == mainModule)
+            continue;
+        if (mainModule != nullptr) {
+            std::cout << "Multiple modules with a main function! Aborting..." << std::endl;
+            std::cout << "Module 1 was " << module->name() << ", Module 2 was " << mainModule->name() <<
+            std::endl;
+            return 2;
         }
+        mainModule = module;
     }
 
     if (mainModule == nullptr) {
@@ -97,11 +96,11 @@ int main(int argc, char** argv) {
 
         vm.startAtFunction(*mainModule->function("$main"), true);
         std::cout << "Analysing... " << getCurrentMemoryUseage() << " counter: " << vm.state().instructionCounter().toString() << std::endl;
+        HaltingProblemDetector haltingProblemDetector(vm);
         while (!vm.finished()) {
-            vm.step();
+            haltingProblemDetector.step();
             if (vm.instructionCounter().multipleOf(5000000)) {
                 std::cout << "Analysing... " << getCurrentMemoryUseage() << " counter: " << vm.state().instructionCounter().toString() << std::endl;
-                HaltingProblemDetector haltingProblemDetector(vm);
                 if (haltingProblemDetector.isLooping(0)) {
                     std::cout << std::endl << "Program will never stop" << std::endl;
                     haltingProblemDetector.printInfo();
@@ -28,9 +28,15 @@ namespace wasm_module {
                              std::function<Variable(std::vector<Variable>)> givenFunction) {
         FunctionContext context(name(), functionName, returnType, parameterTypes, {});
         Function* function = new Function(context, new NativeInstruction(givenFunction, returnType, parameterTypes));
-        function->module(this);
-        functions_.push_back(function);
-        functionsToDelete_.push_back(function);
+        addFunction(function, true);
+        function->deterministic(false);
+    }
+
+    void Module::addNativeBinding(std::string functionName, const Type* returnType, std::vector<const Type*> parameterTypes,
+                                  std::shared_ptr<NativeBinding> binding) {
+        FunctionContext context(name(), functionName, returnType, parameterTypes, {});
+        Function* function = new Function(context, new NativeInstruction(binding, returnType, parameterTypes));
+        addFunction(function, true);
         function->deterministic(false);
     }
 
@@ -38,9 +44,7 @@ namespace wasm_module {
                                      std::function<Variable(std::vector<Variable>)> givenFunction) {
         FunctionContext context(name(), functionName, returnType, {});
         Function* function = new Function(context, new NativeInstruction(givenFunction, returnType, {}));
-        function->module(this);
-        functions_.push_back(function);
-        functionsToDelete_.push_back(function);
+        addFunction(function, true);
         function->deterministic(false);
     }
 }
\ No newline at end of file
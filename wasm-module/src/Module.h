@@ -28,6 +28,9 @@
 #include "FunctionTypeTable.h"
 #include <vector>
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include "NativeBinding.h"
 
 namespace wasm_module {
 
@@ -41,6 +44,8 @@ namespace wasm_module {
         std::vector<std::string> requiredModules_;
         std::vector<Function*> functions_;
         std::vector<Function*> functionsToDelete_;
+        // if two functions share a name, the first one is found as with a linear search
+        std::unordered_map<std::string, const Function*> functionsByName_;
         std::map<std::string, const Function*> exportedFunction_;
 
         HeapData heapData_;
@@ -71,19 +76,27 @@ namespace wasm_module {
         void addFunction(Function* function, bool takeMemoryOwnership = false) {
             function->module(this);
             functions_.push_back(function);
+            functionsByName_.insert(std::make_pair(function->name(), function));
             if (takeMemoryOwnership)
                 functionsToDelete_.push_back(function);
         }
 
+        bool hasFunction(const std::string& functionName) const {
+            return functionsByName_.find(functionName) != functionsByName_.end();
+        }
+
         const Function* function(const std::string& functionName) const {
-            for (const Function* function : functions_) {
-                if (function->name() == functionName) {
-                    return function;
-                }
+            auto iter = functionsByName_.find(functionName);
+            if (iter != functionsByName_.end()) {
+                return iter->second;
             }
             throw NoFunctionWithName("Module " + name() + " has no function with name " + functionName);
         }
 
+        const std::map<std::string, const Function*>& exportedFunctions() const {
+            return exportedFunction_;
+        }
+
         const Function* exportedFunction(const std::string& exportName) const {
             auto iter = exportedFunction_.find(exportName);
 
@@ -116,14 +129,33 @@ namespace wasm_module {
 
         void addFunction(std::string functionName, const Type* returnType, std::vector<const Type*> parameterTypes, std::function<Variable(std::vector<Variable>)> givenFunction);
 
+        /**
+         * Adds a native function with a C++ signature. The parameters are converted directly from
+         * the raw values on the stack of the interpreter, so calling these functions doesn't allocate.
+         * Example: module.addTypedFunction<int32_t(int32_t, double)>("foo", [](int32_t a, double b) { ... });
+         */
+        template<typename Signature>
+        void addTypedFunction(std::string functionName, std::function<Signature> givenFunction) {
+            addNativeBinding(functionName, TypedNativeBinding<Signature>::returnType(),
+                             TypedNativeBinding<Signature>::parameterTypes(),
+                             std::make_shared<TypedNativeBinding<Signature>>(givenFunction));
+        }
+
+        template<typename R, typename... Args>
+        void addTypedFunction(std::string functionName, R (*givenFunction)(Args...)) {
+            addTypedFunction<R(Args...)>(functionName, std::function<R(Args...)>(givenFunction));
+        }
+
+        void addNativeBinding(std::string functionName, const Type* returnType, std::vector<const Type*> parameterTypes,
+                              std::shared_ptr<NativeBinding> binding);
+
         void addVariadicFunction(std::string functionName, const Type *returnType,
                                  std::function<Variable(std::vector<Variable>)> givenFunction);
 
         const Function& getFunction(const std::string& functionName) const {
-            for (Function* function : functions_) {
-                if (function->name() == functionName) {
-                    return *function;
-                }
+            auto iter = functionsByName_.find(functionName);
+            if (iter != functionsByName_.end()) {
+                return *iter->second;
             }
             throw NoFunctionWithName(functionName + " in module " + name());
         }
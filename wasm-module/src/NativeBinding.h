@@ -0,0 +1,137 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef WASMINT_NATIVEBINDING_H
+#define WASMINT_NATIVEBINDING_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <types/Int32.h>
+#include <types/Int64.h>
+#include <types/Float32.h>
+#include <types/Float64.h>
+#include <types/Void.h>
+
+namespace wasm_module {
+
+    /**
+     * Maps the C++ types that can be passed to and returned from typed native
+     * functions to their wasm types. Other types fail at compile time.
+     */
+    template<typename T>
+    struct NativeType;
+
+    template<> struct NativeType<int32_t> { static const Type* type() { return Int32::instance(); } };
+    template<> struct NativeType<uint32_t> { static const Type* type() { return Int32::instance(); } };
+    template<> struct NativeType<int64_t> { static const Type* type() { return Int64::instance(); } };
+    template<> struct NativeType<uint64_t> { static const Type* type() { return Int64::instance(); } };
+    template<> struct NativeType<float> { static const Type* type() { return Float32::instance(); } };
+    template<> struct NativeType<double> { static const Type* type() { return Float64::instance(); } };
+    template<> struct NativeType<void> { static const Type* type() { return Void::instance(); } };
+
+    /**
+     * A native function that works directly on raw values. A raw value is the value of
+     * a Variable stored in the lower bytes of a zeroed uint64_t.
+     */
+    class NativeBinding {
+    public:
+        virtual ~NativeBinding() {
+        }
+
+        /**
+         * Calls the function with the parameters at parameters[0] ... parameters[n - 1]
+         * and returns the raw result (0 for void functions).
+         */
+        virtual uint64_t call(const uint64_t* parameters) const = 0;
+
+        template<typename T>
+        static T fromRaw(uint64_t value) {
+            T result;
+            std::memcpy(&result, &value, sizeof(T));
+            return result;
+        }
+
+        template<typename T>
+        static uint64_t toRaw(T value) {
+            uint64_t result = 0;
+            std::memcpy(&result, &value, sizeof(T));
+            return result;
+        }
+    };
+
+    namespace native_binding_detail {
+        template<std::size_t... Indexes>
+        struct IndexList {
+        };
+
+        template<std::size_t N, std::size_t... Indexes>
+        struct MakeIndexList : MakeIndexList<N - 1, N - 1, Indexes...> {
+        };
+
+        template<std::size_t... Indexes>
+        struct MakeIndexList<0, Indexes...> {
+            typedef IndexList<Indexes...> type;
+        };
+    }
+
+    template<typename Signature>
+    class TypedNativeBinding;
+
+    /**
+     * Trampoline that unpacks the raw parameters into the typed C++ function.
+     */
+    template<typename R, typename... Args>
+    class TypedNativeBinding<R(Args...)> : public NativeBinding {
+
+        std::function<R(Args...)> function_;
+
+        template<std::size_t... Indexes>
+        uint64_t invoke(const uint64_t* parameters, native_binding_detail::IndexList<Indexes...>, std::false_type) const {
+            return toRaw<R>(function_(fromRaw<Args>(parameters[Indexes])...));
+        }
+
+        // void functions
+        template<std::size_t... Indexes>
+        uint64_t invoke(const uint64_t* parameters, native_binding_detail::IndexList<Indexes...>, std::true_type) const {
+            function_(fromRaw<Args>(parameters[Indexes])...);
+            return 0;
+        }
+
+    public:
+        TypedNativeBinding(std::function<R(Args...)> function) : function_(function) {
+        }
+
+        virtual uint64_t call(const uint64_t* parameters) const override {
+            return invoke(parameters, typename native_binding_detail::MakeIndexList<sizeof...(Args)>::type(),
+                          std::is_void<R>());
+        }
+
+        static const Type* returnType() {
+            return NativeType<R>::type();
+        }
+
+        static std::vector<const Type*> parameterTypes() {
+            return {NativeType<Args>::type()...};
+        }
+    };
+}
+
+#endif //WASMINT_NATIVEBINDING_H
@@ -26,6 +26,8 @@
 #include <sexpr_parsing/SExpr.h>
 #include <ModuleContext.h>
 #include <functional>
+#include <memory>
+#include <NativeBinding.h>
 #include <Utils.h>
 #include "Instruction.h"
 #include "InstructionId.h"
@@ -838,6 +840,7 @@ namespace wasm_module {
     class NativeInstruction : public Instruction {
 
         std::function<Variable(std::vector<Variable>)> internalFunction_;
+        std::shared_ptr<NativeBinding> binding_;
         std::vector<const Type*> parameterTypes_;
         const Type* returnType_;
 
@@ -847,6 +850,32 @@ namespace wasm_module {
         {
         }
 
+        NativeInstruction(std::shared_ptr<NativeBinding> binding, const Type* returnType, std::vector<const Type*> parameterTypes)
+                : binding_(binding), parameterTypes_(parameterTypes), returnType_(returnType)
+        {
+            // keeps call() working for users that only know the Variable based interface
+            internalFunction_ = [binding, returnType](std::vector<Variable> parameters) {
+                std::vector<uint64_t> rawParameters;
+                rawParameters.reserve(parameters.size());
+                for (const Variable& parameter : parameters) {
+                    rawParameters.push_back(parameter.primitiveValue());
+                }
+                uint64_t rawResult = binding->call(rawParameters.data());
+                Variable result(returnType);
+                if (returnType != Void::instance())
+                    result.setFromPrimitiveValue(rawResult);
+                return result;
+            };
+        }
+
+        /**
+         * The typed binding of this function or a nullptr if this function only
+         * has the Variable based interface.
+         */
+        const NativeBinding* binding() const {
+            return binding_.get();
+        }
+
         virtual const std::vector<const Type*>& childrenTypes() const override {
             return parameterTypes_;
         }
@@ -1167,6 +1196,18 @@ namespace wasm_module {
         virtual void secondStepEvaluate(ModuleContext& context, FunctionContext& functionContext) override {
             functionSignature = context.mainFunctionTable().getFunctionSignature(functionName);
             moduleName = context.name();
+            // the children can only be checked once we know the signature of the called function
+            if (children().size() != childrenTypes().size()) {
+                throw IncompatibleNumberOfChildren(name() + " got " + std::to_string(children().size()) + " children, but expected " +  std::to_string(childrenTypes().size()));
+            }
+            for (std::size_t i = 0; i < children().size(); i++) {
+                if (UnreachableValidator::willNeverEvaluate(children()[i])) {
+                    continue;
+                }
+                if (!Type::typeCompatible(childrenTypes()[i], children()[i]->returnType())) {
+                    throw IncompatibleChildReturnType(name() + " expected " + childrenTypes()[i]->name() + " but got " + children()[i]->returnType()->name());
+                }
+            }
         }
 
     public:
@@ -1202,6 +1243,11 @@ namespace wasm_module {
         virtual std::string dataString() const override {
             return name() + " " + functionName;
         }
+
+        virtual bool typeCheckChildren() const override {
+            // done in secondStepEvaluate
+            return false;
+        }
     };
 
     class CallIndirect : public Instruction {
@@ -170,6 +170,10 @@ namespace wasm_module { namespace sexpr {
                 const SExpr& expr = funcExpr[i];
 
                 if (expr.hasValue()) {
+                    // (func $name ...)
+                    if (i == 1 && Utils::hasDollarPrefix(expr.value())) {
+                        functionName_ = expr.value();
+                    }
                     continue;
                 }
 
@@ -136,7 +136,8 @@ void ModuleConverter::appendFunctionDefinition(const wasm_module::Function* func
     std::size_t localIndex = function->parameters().size();
     for (const wasm_module::Type* localType : function->pureLocals()) {
         indent(4);
-        cSource_ << toCType(localType) << " " << variableName(function, localIndex) << ";\n";
+        // locals start with the value zero
+        cSource_ << toCType(localType) << " " << variableName(function, localIndex) << " = 0;\n";
         localIndex++;
     }
 
@@ -980,26 +981,35 @@ void ModuleConverter::serializeInstruction(const wasm_module::Instruction& instr
             serializeInstruction(*instruction.children().at(2), indentation + 4);
             if (instruction.returnType() != wasm_module::Void::instance()) {
                 indent(indentation + 4);
-                cSource_ << functionConverter(&instruction) << " = " << functionConverter(instruction.children().at(1)) << ";\n";
+                cSource_ << functionConverter(&instruction) << " = " << functionConverter(instruction.children().at(2)) << ";\n";
             }
             indent(indentation);
             cSource_ << "}\n";
             break;
         case InstructionId::Loop:
+            // label 0 continues the loop and label 1 leaves it
             indent(indentation);
-            cSource_ << functionConverter.getLabel(&instruction) << "_1:;\n";
+            cSource_ << functionConverter.getLabel(&instruction) << "_0:;\n";
 
             for (const wasm_module::Instruction* child : instruction.children()) {
                 serializeInstruction(*child, indentation);
             }
+            if (instruction.returnType() != wasm_module::Void::instance()) {
+                indent(indentation);
+                cSource_ << functionConverter(&instruction) << " = " << functionConverter(instruction.children().back()) << ";\n";
+            }
             indent(indentation);
-            cSource_ << functionConverter.getLabel(&instruction) << "_0:;\n";
+            cSource_ << functionConverter.getLabel(&instruction) << "_1:;\n";
             break;
 
         case InstructionId::Label:
             for (const wasm_module::Instruction* child : instruction.children()) {
                 serializeInstruction(*child, indentation);
             }
+            if (instruction.returnType() != wasm_module::Void::instance()) {
+                indent(indentation);
+                cSource_ << functionConverter(&instruction) << " = " << functionConverter(instruction.children().back()) << ";\n";
+            }
             indent(indentation);
             cSource_ << functionConverter.getLabel(&instruction) << "_0:;\n";
             break;
@@ -1007,6 +1017,10 @@ void ModuleConverter::serializeInstruction(const wasm_module::Instruction& instr
             for (const wasm_module::Instruction* child : instruction.children()) {
                 serializeInstruction(*child, indentation);
             }
+            if (instruction.returnType() != wasm_module::Void::instance()) {
+                indent(indentation);
+                cSource_ << functionConverter(&instruction) << " = " << functionConverter(instruction.children().back()) << ";\n";
+            }
             indent(indentation);
             cSource_ << functionConverter.getLabel(&instruction) << "_0:;\n";
             break;
@@ -1623,8 +1637,7 @@ void ModuleConverter::serializeInstruction(const wasm_module::Instruction& instr
 }
 
 void ModuleConverter::appendTrap(const wasm_module::Instruction& instruction, std::string reason, std::size_t indentation) {
+    // a single statement, as the callers emit it as the body of an if without braces
     indent(indentation);
-    cSource_ << "fprintf(stderr, \"Got trap in instruction " << instruction.name() << " (" << reason << ")\");\n";
-    indent(indentation);
-    cSource_ << "abort();\n";
+    cSource_ << "{ fprintf(stderr, \"Got trap in instruction " << instruction.name() << " (" << reason << ")\"); abort(); }\n";
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2015 WebAssembly Community Group
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <Module.h>
+#include <sexpr_parsing/ModuleParser.h>
+#include <assert.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "../ModuleConverter.h"
+
+using namespace wasm_module;
+using namespace wasm_module::sexpr;
+
+// Converts the module to C, compiles and runs it. Returns true if the program exited without a trap.
+bool runConverted(const std::string& directory, const std::string& moduleSource) {
+    Module* module = ModuleParser::parse(moduleSource);
+    ModuleConverter converter(module);
+
+    std::string sourcePath = directory + "/module.c";
+    std::string binaryPath = directory + "/module";
+    {
+        std::ofstream sourceFile(sourcePath.c_str());
+        sourceFile << converter.cSource();
+    }
+
+    std::string compileCommand = std::string(WASM2C_TEST_CC) + " -o " + binaryPath + " " + sourcePath + " -lm";
+    if (std::system(compileCommand.c_str()) != 0) {
+        std::cerr << "Failed to compile the C source of module " << moduleSource << std::endl;
+        std::abort();
+    }
+    int status = std::system(binaryPath.c_str());
+
+    std::remove(sourcePath.c_str());
+    std::remove(binaryPath.c_str());
+    delete module;
+    return status == 0;
+}
+
+// $main traps if $test doesn't return the expected value
+std::string expectResult(const std::string& testFunction, const std::string& expected) {
+    return "module (memory 1 1) " + testFunction + " (func $main (if (i32.ne (call $test) (i32.const " + expected + ")) (unreachable)))";
+}
+
+int main() {
+    char directoryTemplate[] = "/tmp/wasm2c_ConversionTest_XXXXXX";
+    const char* directory = mkdtemp(directoryTemplate);
+    assert(directory != nullptr);
+
+    // a mismatch has to be detected
+    assert(!runConverted(directory, expectResult("(func $test (result i32) (i32.const 1))", "2")));
+
+    // the trap checks of float truncations only trap for values out of range
+    assert(runConverted(directory, expectResult("(func $test (result i32) (i32.trunc_s/f32 (f32.const 2.5)))", "2")));
+    assert(runConverted(directory, expectResult("(func $test (result i32) (i32.trunc_s/f64 (f64.const -2.5)))", "-2")));
+
+    // locals start with the value zero, even if the stack below them was used before
+    assert(runConverted(directory, "module (memory 1 1)"
+            "(func $dirty (local $a i32) (set_local $a (i32.const 12345)))"
+            "(func $test (result i32) (local $a i32) (get_local $a))"
+            "(func $main (call $dirty) (if (i32.ne (call $test) (i32.const 0)) (unreachable)))"));
+
+    // branching to the continue label of a loop repeats it
+    assert(runConverted(directory, "module (memory 1 1)"
+            "(func $main (local $i i32)"
+            "  (loop $exit $cont"
+            "    (set_local $i (i32.add (get_local $i) (i32.const 1)))"
+            "    (br_if $cont (i32.lt_s (get_local $i) (i32.const 10))))"
+            "  (if (i32.ne (get_local $i) (i32.const 10)) (unreachable)))"));
+
+    // block, label and loop have the value of their last child
+    assert(runConverted(directory, expectResult("(func $test (result i32) (block (i32.const 1) (i32.const 7)))", "7")));
+    assert(runConverted(directory, expectResult("(func $test (result i32) (label $l (i32.const 7)))", "7")));
+    assert(runConverted(directory, expectResult("(func $test (result i32) (loop (nop) (i32.const 7)))", "7")));
+
+    // if_else has the value of the branch it took
+    assert(runConverted(directory, expectResult("(func $test (result i32) (if_else (i32.const 1) (i32.const 1) (i32.const 2)))", "1")));
+    assert(runConverted(directory, expectResult("(func $test (result i32) (if_else (i32.const 0) (i32.const 1) (i32.const 2)))", "2")));
+
+    rmdir(directory);
+}
@@ -31,8 +31,8 @@ bool TestCase::run(wasmint::WasmintVM& vm) {
         assert(false);
     } else if (type_ == Type::AssertTrap) {
         wasmint::VMState stateCopy = vm.state();
-        const wasm_module::Function* function = getExportedFunction(vm);
-        vm.startAtFunction(*function, parameters_, false);
+        wasmint::FunctionHandle function = getExportedFunction(vm);
+        vm.startAtFunction(function, parameters_, false);
 
         wasmint::WasmintVMTester tester(vm);
         tester.stepUntilFinished();
@@ -50,10 +50,8 @@ bool TestCase::run(wasmint::WasmintVM& vm) {
         vm.state() = stateCopy;
         return true;
     } else if (type_ == Type::Invoke) {
-        const wasm_module::Function* function = getExportedFunction(vm);
-        if (function == nullptr)
-            return false;
-        vm.startAtFunction(*function, parameters_, false);
+        wasmint::FunctionHandle function = getExportedFunction(vm);
+        vm.startAtFunction(function, parameters_, false);
 
         wasmint::WasmintVMTester tester(vm);
         tester.stepUntilFinished();
@@ -64,8 +62,8 @@ bool TestCase::run(wasmint::WasmintVM& vm) {
         }
         return true;
     } else if (type_ == Type::AssertReturn) {
-        const wasm_module::Function* function = getExportedFunction(vm);
-        vm.startAtFunction(*function, parameters_, true);
+        wasmint::FunctionHandle function = getExportedFunction(vm);
+        vm.startAtFunction(function, parameters_, true);
 
         wasmint::WasmintVMTester tester(vm);
         tester.stepUntilFinished();
@@ -81,8 +79,8 @@ bool TestCase::run(wasmint::WasmintVM& vm) {
                     vm.state().thread().result().toString() << "\n" << testCaseExpr_.toString(4) << std::endl;
         }
     } else if (type_ == Type::AssertReturnNan) {
-        const wasm_module::Function* function = getExportedFunction(vm);
-        vm.startAtFunction(*function, parameters_, false);
+        wasmint::FunctionHandle function = getExportedFunction(vm);
+        vm.startAtFunction(function, parameters_, false);
 
         wasmint::WasmintVMTester tester(vm);
         tester.stepUntilFinished();
@@ -168,23 +166,19 @@ wasm_module::Variable TestCase::parseVariable(const wasm_module::sexpr::SExpr& e
     return result;
 }
 
-const wasm_module::Function *TestCase::getExportedFunction(wasmint::WasmintVM& vm) {
-    for (const wasm_module::Module* module : vm.modules()) {
-        try {
-            const wasm_module::Function* exportedFunction = module->exportedFunction(functionToCall_);
-            if (exportedFunction->parameters().size() == parameters_.size()) {
-                bool parametersFit = true;
-                for (std::size_t i = 0; i < parameters_.size(); i++) {
-                    if (exportedFunction->parameters()[i] != &parameters_[i].type()) {
-                        parametersFit = false;
-                        break;
-                    }
+wasmint::FunctionHandle TestCase::getExportedFunction(wasmint::WasmintVM& vm) {
+    for (const wasmint::FunctionHandle& handle : vm.exportedFunctions(functionToCall_)) {
+        const wasm_module::Function& exportedFunction = handle.function();
+        if (exportedFunction.parameters().size() == parameters_.size()) {
+            bool parametersFit = true;
+            for (std::size_t i = 0; i < parameters_.size(); i++) {
+                if (exportedFunction.parameters()[i] != &parameters_[i].type()) {
+                    parametersFit = false;
+                    break;
                 }
-                if (parametersFit)
-                    return exportedFunction;
             }
-        } catch (const wasm_module::NoExportWithName& ex) {
-            // pass
+            if (parametersFit)
+                return handle;
         }
     }
     throw CouldNotFindExportedFunction(functionToCall_);
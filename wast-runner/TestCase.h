@@ -53,7 +53,7 @@ class TestCase {
 
     wasm_module::Variable parseVariable(const wasm_module::sexpr::SExpr& expr);
 
-    const wasm_module::Function * getExportedFunction(wasmint::WasmintVM& vm);
+    wasmint::FunctionHandle getExportedFunction(wasmint::WasmintVM& vm);
 
 public:
     TestCase(const wasm_module::sexpr::SExpr& expr);